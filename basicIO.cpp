@@ -1,4 +1,5 @@
 #include "include/basicIO.h"
+#include "include/Perf.h"
 
 #define SYS_READ 0
 #define SYS_WRITE 1
@@ -17,6 +18,7 @@ void basicIO::activateInput() {
 
 int basicIO::inputint() {
     char buffer[32] = {0};
+    PERF_COUNT(IO_SYSCALLS);
     long bytes = syscall3(0, 0, (long)buffer, 31);
     if (bytes <= 0) return 0;
     buffer[bytes] = '\0';
@@ -34,6 +36,7 @@ int basicIO::inputint() {
 }
 
 const char* basicIO::inputstring() {
+    PERF_COUNT(IO_SYSCALLS);
     syscall3(SYS_READ, STDIN, (long)inputBuffer, 255);
     return inputBuffer;
 }
@@ -45,6 +48,7 @@ void basicIO::inputstring(char* buffer, int size) {
     int i = 0;
 
     while (i < size - 1) {
+        PERF_COUNT(IO_SYSCALLS);
         long bytes = syscall3(SYS_READ, STDIN, (long)&ch, 1);
         if (bytes <= 0 || ch == '\n') break;
         buffer[i++] = ch;
@@ -71,6 +75,7 @@ void basicIO::outputint(int number) {
             buffer[i++] = '-';
         }
     }
+    PERF_COUNT_N(IO_SYSCALLS, i);
     for (int j = i - 1; j >= 0; --j) {
         syscall3(SYS_WRITE, STDOUT, (long)&buffer[j], 1);
     }
@@ -79,17 +84,20 @@ void basicIO::outputint(int number) {
 void basicIO::outputstring(const char* text) {
     long len = 0;
     while (text[len]) ++len;
+    PERF_COUNT(IO_SYSCALLS);
     syscall3(SYS_WRITE, STDOUT, (long)text, len);
 }
 
 void basicIO::terminate() {
     char newline = '\n';
+    PERF_COUNT(IO_SYSCALLS);
     syscall3(SYS_WRITE, STDOUT, (long)&newline, 1);
 }
 
 void basicIO::errorstring(const char* text) {
     long len = 0;
     while (text[len]) ++len;
+    PERF_COUNT(IO_SYSCALLS);
     syscall3(SYS_WRITE, 2, (long)text, len);
 }
 
@@ -112,6 +120,7 @@ void basicIO::errorint(int number) {
             buffer[i++] = '-';
         }
     }
+    PERF_COUNT_N(IO_SYSCALLS, i);
     for (int j = i - 1; j >= 0; --j) {
         syscall3(SYS_WRITE, 2, (long)&buffer[j], 1);
     }
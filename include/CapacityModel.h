@@ -0,0 +1,164 @@
+#pragma once
+#include "NetworkConfig.h"
+
+// 🔥 Radio-aware slot capacity. Instead of a fixed users-per-slot figure,
+// each user gets an SINR drawn from the generation's configured
+// distribution. The SINR maps to a spectral efficiency (attenuated Shannon,
+// or the LTE CQI table), and the user's service demand divided by that
+// efficiency is the carrier bandwidth it occupies. A slot admits users
+// while the summed demand fits its carrier.
+//
+// All kernels work on structure-of-arrays input four lanes at a time (SSE
+// through GCC vector extensions). exp2/log2 are short polynomials. Draw k of
+// an engine's SINR series depends only on k, so GenerationManager fills the
+// efficiencies of its next admissions a block at a time with
+// drawSinrSeries() and efficiency(), and each admission divides its demand
+// by the prefetched value.
+class CapacityModel {
+public:
+    static constexpr float SHANNON_ALPHA = 0.6f;   // implementation loss (TR 36.942)
+    static constexpr float SHANNON_MAX = 4.4f;     // bit/s/Hz ceiling
+    static constexpr float SHANNON_MIN_DB = -10.0f;
+    static constexpr float UNSERVABLE = 1e30f;     // kHz needed below the coverage floor
+
+    // SINR in dB -> spectral efficiency in bit/s/Hz (0 = out of coverage)
+    static void efficiency(const float* sinr_db, float* eff, long n, int kind) {
+        long i = 0;
+        for (; i + 4 <= n; i += 4) store(eff + i, efficiency4(load(sinr_db + i), kind));
+        if (i < n) {
+            float in[4] = {SHANNON_MIN_DB - 1, SHANNON_MIN_DB - 1, SHANNON_MIN_DB - 1, SHANNON_MIN_DB - 1};
+            float out[4];
+            int tail = static_cast<int>(n - i) & 3;
+            for (int k = 0; k < tail; ++k) in[k] = sinr_db[i + k];
+            store(out, efficiency4(load(in), kind));
+            for (int k = 0; k < tail; ++k) eff[i + k] = out[k];
+        }
+    }
+
+    // Gaussian SINR draws (Irwin-Hall sum of four uniforms), reproducible per seed
+    static void drawSinr(float* out, long n, unsigned long seed, float mean_db, float spread_db) {
+        v4u s;
+        for (int l = 0; l < 4; ++l) {
+            seed = mix(seed + 0x9E3779B97F4A7C15UL);
+            s[l] = static_cast<unsigned int>(seed) | 1;
+        }
+        for (long i = 0; i < n; i += 4) {
+            v4f v = gaussian4(s, mean_db, spread_db);
+            if (i + 4 <= n) store(out + i, v);
+            else for (long k = i; k < n; ++k) out[k] = v[k - i];
+        }
+    }
+
+    // out[i] = first_seed + i's single draw: drawSinr(out + i, 1, first_seed + i)
+    // for every i, four seeds per pass
+    static void drawSinrSeries(float* out, long n, unsigned long first_seed, float mean_db, float spread_db) {
+        for (long i = 0; i < n; i += 4) {
+            v4u s;
+            for (int l = 0; l < 4; ++l)
+                s[l] = static_cast<unsigned int>(mix(first_seed + i + l + 0x9E3779B97F4A7C15UL)) | 1;
+            v4f v = gaussian4(s, mean_db, spread_db);
+            if (i + 4 <= n) store(out + i, v);
+            else for (long k = i; k < n; ++k) out[k] = v[k - i];
+        }
+    }
+
+    // Carrier kHz a `service` user occupies at spectral efficiency `eff`
+    static float needAt(int service, float eff, const int* demand_kbps) {
+        if (eff <= 1e-6f) return UNSERVABLE;
+        return static_cast<float>(demand_kbps[NetworkConfig::serviceSlot(service)]) / eff;
+    }
+
+    // One user: kHz needed for `service` at `sinr_db`
+    static float userNeed(int service, float sinr_db, int kind, const int* demand_kbps) {
+        float in[1] = {sinr_db};
+        float eff[1];
+        efficiency(in, eff, 1, kind);
+        return needAt(service, eff[0], demand_kbps);
+    }
+
+private:
+    typedef float v4f __attribute__((vector_size(16)));
+    typedef int v4i __attribute__((vector_size(16)));
+    typedef unsigned int v4u __attribute__((vector_size(16)));
+
+    static v4f splat(float x) { return v4f{x, x, x, x}; }
+    static v4f load(const float* p) { v4f v; __builtin_memcpy(&v, p, sizeof(v)); return v; }
+    static void store(float* p, v4f v) { __builtin_memcpy(p, &v, sizeof(v)); }
+
+    // Four xorshift steps per lane, summed and scaled to N(mean, spread)
+    static v4f gaussian4(v4u& s, float mean_db, float spread_db) {
+        const v4f unit = splat(1.0f / 16777216);
+        v4f sum = splat(0);
+        for (int k = 0; k < 4; ++k) {
+            s ^= s << 13;
+            s ^= s >> 17;
+            s ^= s << 5;
+            sum += __builtin_convertvector(s >> 8, v4f) * unit;
+        }
+        // sqrt(12 / 4) = 1.7320508: unit variance
+        return sum * splat(spread_db * 1.7320508f) + splat(mean_db - 2.0f * spread_db * 1.7320508f);
+    }
+
+    static unsigned long mix(unsigned long x) {
+        x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9UL;
+        x = (x ^ (x >> 27)) * 0x94D049BB133111EBUL;
+        return x ^ (x >> 31);
+    }
+
+    static v4f efficiency4(v4f sinr, int kind) {
+        if (kind == NetworkConfig::CAPACITY_CQI) return cqi4(sinr);
+        // alpha * log2(1 + 10^(dB/10)), capped, zero below the coverage floor
+        v4f clamped = sinr > splat(40.0f) ? splat(40.0f) : sinr;
+        v4f eff = splat(SHANNON_ALPHA) * log2_4(splat(1.0f) + exp2_4(clamped * splat(0.33219281f)));
+        eff = eff > splat(SHANNON_MAX) ? splat(SHANNON_MAX) : eff;
+        return sinr < splat(SHANNON_MIN_DB) ? splat(0) : eff;
+    }
+
+    // 4-bit CQI (TS 36.213 table 7.2.3-1) with the usual 10% BLER SINR thresholds
+    static v4f cqi4(v4f sinr) {
+        static const float threshold[15] = {-6.7f, -4.7f, -2.3f, 0.2f, 2.4f, 4.3f, 5.9f, 8.1f,
+                                            10.3f, 11.7f, 14.1f, 16.3f, 18.7f, 21.0f, 22.7f};
+        static const float table[15] = {0.1523f, 0.2344f, 0.3770f, 0.6016f, 0.8770f, 1.1758f, 1.4766f, 1.9141f,
+                                        2.4063f, 2.7305f, 3.3223f, 3.9023f, 4.5234f, 5.1152f, 5.5547f};
+        v4f eff = splat(0);
+        for (int q = 0; q < 15; ++q) eff = sinr >= splat(threshold[q]) ? splat(table[q]) : eff;
+        return eff;
+    }
+
+    // 2^x for |x| < 126: integer part into the exponent, degree-6 Taylor on [0, 1)
+    static v4f exp2_4(v4f x) {
+        v4i xi = __builtin_convertvector(x, v4i);
+        xi -= (x < __builtin_convertvector(xi, v4f)) ? v4i{1, 1, 1, 1} : v4i{0, 0, 0, 0};   // floor
+        v4f f = x - __builtin_convertvector(xi, v4f);
+        v4f p = splat(1.5403530e-4f);
+        p = p * f + splat(1.3333558e-3f);
+        p = p * f + splat(9.6181291e-3f);
+        p = p * f + splat(5.5504109e-2f);
+        p = p * f + splat(2.4022651e-1f);
+        p = p * f + splat(6.9314718e-1f);
+        p = p * f + splat(1.0f);
+        v4i bits;
+        __builtin_memcpy(&bits, &p, sizeof(bits));
+        bits += xi << 23;
+        __builtin_memcpy(&p, &bits, sizeof(p));
+        return p;
+    }
+
+    // log2(x) for x >= 1: exponent plus an atanh series on the mantissa
+    static v4f log2_4(v4f x) {
+        v4i bits;
+        __builtin_memcpy(&bits, &x, sizeof(bits));
+        v4f e = __builtin_convertvector((bits >> 23) - 127, v4f);
+        bits = (bits & 0x007FFFFF) | 0x3F800000;
+        v4f m;
+        __builtin_memcpy(&m, &bits, sizeof(m));   // [1, 2)
+        v4f t = (m - splat(1.0f)) / (m + splat(1.0f));
+        v4f t2 = t * t;
+        v4f s = splat(1.0f / 9);
+        s = s * t2 + splat(1.0f / 7);
+        s = s * t2 + splat(1.0f / 5);
+        s = s * t2 + splat(1.0f / 3);
+        s = s * t2 + splat(1.0f);
+        return e + splat(2.8853901f) * t * s;   // 2 / ln 2
+    }
+};
@@ -1,6 +1,8 @@
 #pragma once
 #include "UserDevice.h"
 #include "CellularCore.h"
+#include "NetworkConfig.h"
+#include "SpectrumPlan.h"
 
 class CellTower {
 protected:
@@ -13,18 +15,13 @@ protected:
     bool mimo_enabled;
     CellularCore<long>* core;
     static const int MAX_USERS = 10000;
-    UserDevice users[MAX_USERS];
+    UserDevice* users;   // grown on demand up to MAX_USERS
+    int user_capacity;
     int user_count;
 
     // Per-frequency slots (for multi-band support)
-    struct FreqSlot {
-        int freq_mhz;
-        int current_users;
-        int max_users;
-    };
-    static const int MAX_SLOTS = 20;
-    FreqSlot slots[MAX_SLOTS];
-    int slot_count;
+    SpectrumPlan slots;
+    int service_messages[NetworkConfig::MAX_SERVICES];
 
     virtual int computeMessages(int service_type) const = 0;
 
@@ -34,7 +31,7 @@ public:
               int upc, int ant, bool mimo, CellularCore<long>* c)
         : total_spectrum_mhz(total_spec_mhz), channel_bandwidth_mhz(chan_bw),
           users_per_channel(upc), antenna_factor(ant), mimo_enabled(mimo),
-          core(c), user_count(0), slot_count(0) {
+          core(c), users(nullptr), user_capacity(0), user_count(0) {
         // Copy name
         int i = 0;
         while (name[i] && i < 31) { tech_name[i] = name[i]; ++i; }
@@ -44,7 +41,17 @@ public:
         protocol[i] = '\0';
     }
 
-    virtual ~CellTower() {}
+    CellTower(const NetworkConfig& cfg, const char* proto, CellularCore<long>* c)
+        : CellTower(cfg.name, proto, cfg.total_spectrum_mhz, cfg.channel_bandwidth_mhz,
+                    cfg.users_per_channel, cfg.antenna_factor, cfg.mimo_enabled, c) {
+        for (int s = 0; s < NetworkConfig::MAX_SERVICES; ++s)
+            service_messages[s] = cfg.messagesFor(s);
+    }
+
+    virtual ~CellTower() { delete[] users; }
+
+    CellTower(const CellTower&) = delete;
+    CellTower& operator=(const CellTower&) = delete;
 
     virtual void initializeSlots() = 0;
 
@@ -57,23 +64,18 @@ public:
         }
 
         // Find slot
-        int slot_idx = -1;
-        for (int i = 0; i < slot_count; ++i) {
-            if (slots[i].freq_mhz == freq_mhz) {
-                if (slots[i].current_users >= slots[i].max_users) return false;
-                slot_idx = i;
-                break;
-            }
-        }
+        int slot_idx = slots.findSlot(freq_mhz);
         if (slot_idx == -1) return false; // Invalid freq
+        if (slots[slot_idx].current_users >= slots[slot_idx].max_users) return false;
 
         // Register user
+        if (user_count == user_capacity) growUsers();
         users[user_count].setID(user_count + 1);
         users[user_count].setFrequency(freq_mhz);
         users[user_count].setMessages(messages);
         users[user_count].setServiceType(service_type);
         core->registerUser(users[user_count].getID(), messages);
-        slots[slot_idx].current_users++;
+        slots.adjust(slot_idx, 1, messages);
         user_count++;
         return true;
     }
@@ -84,7 +86,7 @@ public:
     }
 
     void getFirstChannelUsers(char out[][32], int& count) const {
-        if (slot_count == 0) { count = 0; return; }
+        if (slots.getSlotCount() == 0) { count = 0; return; }
         int cap = slots[0].max_users;
         count = (user_count < cap) ? user_count : cap;
         for (int i = 0; i < count; ++i) {
@@ -102,135 +104,94 @@ public:
         return (full_load + cap - 1) / cap;
     }
 
+protected:
+    // Expands the profile's band plan into slots
+    void initializeSlotsFrom(const NetworkConfig& cfg) { slots.build(cfg); }
+
+    void growUsers() {
+        int cap = user_capacity > 0 ? user_capacity * 2 : 64;
+        if (cap > MAX_USERS) cap = MAX_USERS;
+        UserDevice* bigger = new UserDevice[cap];
+        for (int i = 0; i < user_count; ++i) bigger[i] = users[i];
+        delete[] users;
+        users = bigger;
+        user_capacity = cap;
+    }
+
+    int lookupMessages(int s) const {
+        if (s < 1 || s >= NetworkConfig::MAX_SERVICES) s = NetworkConfig::MAX_SERVICES - 1;
+        return service_messages[s];
+    }
+
+public:
     // Getters
     const char* getTechName() const { return tech_name; }
     int getUserCount() const { return user_count; }
-    int getSlotCount() const { return slot_count; }
-    int getSlotFreq(int i) const { return (i < slot_count) ? slots[i].freq_mhz : 0; }
-    int getSlotUsers(int i) const { return (i < slot_count) ? slots[i].current_users : 0; }
-    int getSlotMax(int i) const { return (i < slot_count) ? slots[i].max_users : 0; }
+    int getSlotCount() const { return slots.getSlotCount(); }
+    int getSlotFreq(int i) const { return (i < slots.getSlotCount()) ? slots[i].frequency_mhz : 0; }
+    int getSlotUsers(int i) const { return (i < slots.getSlotCount()) ? slots[i].current_users : 0; }
+    int getSlotMax(int i) const { return (i < slots.getSlotCount()) ? slots[i].max_users : 0; }
 };
 
 // --- Concrete Towers ---
+// Capacity, slots and message costs come from NetworkConfig::profile(gen).
 
 class G2Tower : public CellTower {
 public:
     G2Tower(CellularCore<long>* core)
-        : CellTower("2G", "TDMA", 1.0, 0.2, 16, 1, false, core) {
+        : CellTower(NetworkConfig::profile(2), "TDMA", core) {
         initializeSlots();
     }
-    void initializeSlots() override {
-        slot_count = 5;
-        for (int i = 0; i < 5; ++i) {
-            slots[i].freq_mhz = 1800 + i * 200;
-            slots[i].current_users = 0;
-            slots[i].max_users = 16;
-        }
-    }
-    int computeMessages(int s) const override {
-        if (s == 1) return 15;
-        if (s == 2) return 2;
-        if (s == 3) return 5;
-        return 20; // Voice+Data
-    }
+    void initializeSlots() override { initializeSlotsFrom(NetworkConfig::profile(2)); }
+    int computeMessages(int s) const override { return lookupMessages(s); }
 };
 
 class G3Tower : public CellTower {
 public:
     G3Tower(CellularCore<long>* core)
-        : CellTower("3G", "CDMA", 1.0, 0.2, 32, 1, false, core) {
+        : CellTower(NetworkConfig::profile(3), "CDMA", core) {
         initializeSlots();
     }
-    void initializeSlots() override {
-        slot_count = 5;
-        for (int i = 0; i < 5; ++i) {
-            slots[i].freq_mhz = 1800 + i * 200;
-            slots[i].current_users = 0;
-            slots[i].max_users = 32;
-        }
-    }
-    int computeMessages(int s) const override { return 10; }
+    void initializeSlots() override { initializeSlotsFrom(NetworkConfig::profile(3)); }
+    int computeMessages(int s) const override { return lookupMessages(s); }
 };
 
 class G35Tower : public CellTower {
 public:
     G35Tower(CellularCore<long>* core)
-        : CellTower("3.5G", "HSPA", 1.0, 0.2, 64, 1, false, core) {
+        : CellTower(NetworkConfig::profile(4), "HSPA", core) {
         initializeSlots();
     }
-    void initializeSlots() override {
-        slot_count = 5;
-        for (int i = 0; i < 5; ++i) {
-            slots[i].freq_mhz = 1800 + i * 200;
-            slots[i].current_users = 0;
-            slots[i].max_users = 64;
-        }
-    }
-    int computeMessages(int s) const override { return 8; }
+    void initializeSlots() override { initializeSlotsFrom(NetworkConfig::profile(4)); }
+    int computeMessages(int s) const override { return lookupMessages(s); }
 };
 
 class G4Tower : public CellTower {
 public:
     G4Tower(CellularCore<long>* core)
-        : CellTower("4G", "OFDM", 1.0, 0.01, 30, 4, true, core) {
+        : CellTower(NetworkConfig::profile(5), "OFDM", core) {
         initializeSlots();
     }
-    void initializeSlots() override {
-        slot_count = 10;
-        for (int i = 0; i < 10; ++i) {
-            slots[i].freq_mhz = 1800 + i * 10;
-            slots[i].current_users = 0;
-            slots[i].max_users = 30 * 4; // MIMO reuse
-        }
-    }
-    int computeMessages(int s) const override {
-        if (s == 1) return 15;
-        if (s == 2) return 2;
-        if (s == 3) return 25;
-        return 40;
-    }
+    void initializeSlots() override { initializeSlotsFrom(NetworkConfig::profile(5)); }
+    int computeMessages(int s) const override { return lookupMessages(s); }
 };
 
 class G4PlusTower : public CellTower {
 public:
     G4PlusTower(CellularCore<long>* core)
-        : CellTower("4G+", "LTE-A", 1.0, 0.01, 40, 4, true, core) {
+        : CellTower(NetworkConfig::profile(6), "LTE-A", core) {
         initializeSlots();
     }
-    void initializeSlots() override {
-        slot_count = 10;
-        for (int i = 0; i < 10; ++i) {
-            slots[i].freq_mhz = 1800 + i * 10;
-            slots[i].current_users = 0;
-            slots[i].max_users = 40 * 4;
-        }
-    }
-    int computeMessages(int s) const override {
-        if (s == 1) return 12;
-        if (s == 2) return 2;
-        if (s == 3) return 20;
-        return 32;
-    }
+    void initializeSlots() override { initializeSlotsFrom(NetworkConfig::profile(6)); }
+    int computeMessages(int s) const override { return lookupMessages(s); }
 };
 
 class G5Tower : public CellTower {
 public:
     G5Tower(CellularCore<long>* core)
-        : CellTower("5G", "Massive MIMO", 11.0, 1.0, 30, 16, true, core) {
+        : CellTower(NetworkConfig::profile(7), "Massive MIMO", core) {
         initializeSlots();
     }
-    void initializeSlots() override {
-        slot_count = 11;
-        for (int i = 0; i < 11; ++i) {
-            slots[i].freq_mhz = 1800 + i * 1000;
-            slots[i].current_users = 0;
-            slots[i].max_users = 30 * 16;
-        }
-    }
-    int computeMessages(int s) const override {
-        if (s == 1) return 10;
-        if (s == 2) return 2;
-        if (s == 3) return 25;
-        return 15;
-    }
+    void initializeSlots() override { initializeSlotsFrom(NetworkConfig::profile(7)); }
+    int computeMessages(int s) const override { return lookupMessages(s); }
 };
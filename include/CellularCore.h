@@ -8,11 +8,17 @@ private:
     T current_load;
     int registered_count;
     static const int MAX_USERS = 10000;
-    char registered_ids[MAX_USERS][32];
+    char (*registered_ids)[32];   // allocated by the first registration
+    int id_capacity;
 
 public:
     CellularCore(T capacity = 10000) 
-        : max_capacity(capacity), current_load(0), registered_count(0) {}
+        : max_capacity(capacity), current_load(0), registered_count(0), registered_ids(nullptr), id_capacity(0) {}
+
+    ~CellularCore() { delete[] registered_ids; }
+
+    CellularCore(const CellularCore&) = delete;
+    CellularCore& operator=(const CellularCore&) = delete;
 
     bool canRegister(T user_messages) const {
         return (current_load + user_messages) <= max_capacity;
@@ -21,6 +27,7 @@ public:
     bool registerUser(const char* user_id, T user_messages) {
         if (!canRegister(user_messages) || registered_count >= MAX_USERS)
             return false;
+        if (registered_count == id_capacity) growIds();
         int i = 0;
         while (user_id[i] != '\0' && i < 31) {
             registered_ids[registered_count][i] = user_id[i];
@@ -32,7 +39,26 @@ public:
         return true;
     }
 
+    // Hands a preempted user's messages back (the ID table is append-only)
+    void release(T user_messages) {
+        current_load = user_messages < current_load ? current_load - user_messages : 0;
+    }
+
     void reset() { current_load = 0; registered_count = 0; }
     T getMaxCapacity() const { return max_capacity; }
+    T getCurrentLoad() const { return current_load; }
     int getRegisteredCount() const { return registered_count; } // 🔑 ADDED
+
+private:
+    // The ID table doubles from 64 entries, so an idle core costs no memory
+    void growIds() {
+        int cap = id_capacity > 0 ? id_capacity * 2 : 64;
+        if (cap > MAX_USERS) cap = MAX_USERS;
+        char (*bigger)[32] = new char[cap][32];
+        for (int i = 0; i < registered_count; ++i)
+            for (int j = 0; j < 32; ++j) bigger[i][j] = registered_ids[i][j];
+        delete[] registered_ids;
+        registered_ids = bigger;
+        id_capacity = cap;
+    }
 };
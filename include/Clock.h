@@ -0,0 +1,39 @@
+#pragma once
+#include "basicIO.h"
+
+// Monotonic clock through the raw clock_gettime syscall (no libc). That is
+// a kernel entry per call, so it is for coarse timing; hot-path scopes use
+// ticks(), the CPU timestamp counter, converted with a rate calibrated
+// once against nowNs().
+class Clock {
+public:
+    static long nowNs() {
+        struct { long sec; long nsec; } ts = {0, 0};
+        syscall3(228, 1, (long)&ts, 0); // SYS_clock_gettime, CLOCK_MONOTONIC
+        return ts.sec * 1000000000L + ts.nsec;
+    }
+
+    static long elapsedUs(long start_ns) { return (nowNs() - start_ns) / 1000; }
+
+    // Timestamp counter (invariant TSC: constant rate across cores and P-states)
+    static long ticks() { return static_cast<long>(__builtin_ia32_rdtsc()); }
+
+    static long ticksToNs(long ticks) { return static_cast<long>(ticks * nsPerTick()); }
+    static long nsToTicks(long ns) { return static_cast<long>(ns / nsPerTick()); }
+
+private:
+    static double nsPerTick() {
+        static const double rate = calibrate();
+        return rate;
+    }
+
+    // Counts ticks over a 2 ms window of the monotonic clock
+    static double calibrate() {
+        long start_ns = nowNs();
+        long start_ticks = ticks();
+        long now = start_ns;
+        while (now - start_ns < 2000000) now = nowNs();
+        long elapsed_ticks = ticks() - start_ticks;
+        return elapsed_ticks > 0 ? static_cast<double>(now - start_ns) / elapsed_ticks : 1.0;
+    }
+};
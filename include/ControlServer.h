@@ -0,0 +1,382 @@
+#pragma once
+#include "basicIO.h"
+#include "GenerationManager.h"
+#include "OutBuffer.h"
+
+// 🔥 Unix domain socket control/query server. One thread, one level-triggered
+// epoll loop, non-blocking sockets. Requests are newline-terminated text
+// lines; every complete line in a read is executed before the replies for the
+// whole batch leave in one send, so clients can pipeline freely:
+//
+//   ADD <gen> <service> <freq> [carriers] -> OK <freq> <user_id> | ERR <reason>   (freq 0 = auto)
+//   REMOVE <gen> <user_id>       -> OK | ERR NO_USER
+//   QUERY <gen> <freq> [freq2]   -> OK <users_on_freq> | ERR INVALID_FREQ
+//                                   (with freq2: users aggregating both carriers)
+//   STATS <gen>                  -> OK users=.. util=..% full=../.. messages=.. core=../..
+//   PING                         -> OK
+//   SHUTDOWN                     -> OK (server exits once replies are flushed)
+//
+// Only the first letter of a command is significant (A/R/Q/S/P), except SH.
+// A connection whose replies back up stops being read until they drain.
+class ControlServer {
+public:
+    typedef GenerationManager* (*ManagerSource)(int gen);
+
+    static const int MAX_CONNECTIONS = 256;
+    static const int IN_BYTES = 65536;
+    static const int OUT_BYTES = 65536;
+
+    struct Stats {
+        long connections;
+        long requests;
+        long errors;
+        long sends;
+    };
+
+    ControlServer(const char* socket_path, ManagerSource src)
+        : path(socket_path), source(src), listen_fd(-1), epoll_fd(-1), running(false) {
+        stats = Stats{0, 0, 0, 0};
+        for (int i = 0; i < MAX_CONNECTIONS; ++i) conns[i].fd = -1;
+    }
+
+    ~ControlServer() { close(); }
+
+    ControlServer(const ControlServer&) = delete;
+    ControlServer& operator=(const ControlServer&) = delete;
+
+    // Creates the socket and epoll set; false if the path cannot be bound
+    bool open() {
+        struct { unsigned short family; char path[108]; } addr;
+        addr.family = AF_UNIX;
+        int len = 0;
+        while (path[len] && len < 107) { addr.path[len] = path[len]; ++len; }
+        addr.path[len] = '\0';
+
+        syscall3(SYS_UNLINK, (long)path, 0, 0);   // stale socket from a previous run
+        listen_fd = syscall3(SYS_SOCKET, AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        if (listen_fd < 0) return false;
+        if (syscall3(SYS_BIND, listen_fd, (long)&addr, 2 + len + 1) < 0 ||
+            syscall3(SYS_LISTEN, listen_fd, 128, 0) < 0) {
+            close();
+            return false;
+        }
+        epoll_fd = syscall3(SYS_EPOLL_CREATE1, EPOLL_CLOEXEC, 0, 0);
+        if (epoll_fd < 0 || !watch(EPOLL_CTL_ADD, listen_fd, EPOLLIN, LISTEN_TAG)) {
+            close();
+            return false;
+        }
+        return true;
+    }
+
+    // Serves until a SHUTDOWN request; returns the server counters
+    Stats run() {
+        EpollEvent events[64];
+        running = true;
+        while (running) {
+            long n = syscall6(SYS_EPOLL_WAIT, epoll_fd, (long)events, 64, -1, 0, 0);
+            if (n < 0) {
+                if (n == -ERR_INTR) continue;
+                break;
+            }
+            for (long i = 0; i < n; ++i) {
+                unsigned long tag = events[i].data;
+                if (tag == LISTEN_TAG) {
+                    acceptAll();
+                    continue;
+                }
+                Connection& c = conns[tag];
+                if (c.fd < 0) continue;
+                if (events[i].events & EPOLLOUT) {
+                    if (flush(c)) serve(c);   // drained: resume the backlog
+                } else if (events[i].events & EPOLLIN) {
+                    readAndServe(c);          // a hang-up reads as 0 bytes
+                } else if (events[i].events & (EPOLLERR | EPOLLHUP)) {
+                    drop(c);
+                }
+            }
+        }
+        close();
+        return stats;
+    }
+
+    void close() {
+        for (int i = 0; i < MAX_CONNECTIONS; ++i)
+            if (conns[i].fd >= 0) drop(conns[i]);
+        if (epoll_fd >= 0) syscall3(SYS_CLOSE, epoll_fd, 0, 0);
+        if (listen_fd >= 0) {
+            syscall3(SYS_CLOSE, listen_fd, 0, 0);
+            syscall3(SYS_UNLINK, (long)path, 0, 0);
+        }
+        epoll_fd = listen_fd = -1;
+    }
+
+private:
+    // Raw syscall numbers / flags (x86-64)
+    static const long SYS_CLOSE = 3;
+    static const long SYS_READ = 0;
+    static const long SYS_SOCKET = 41;
+    static const long SYS_SENDTO = 44;
+    static const long SYS_BIND = 49;
+    static const long SYS_LISTEN = 50;
+    static const long SYS_UNLINK = 87;
+    static const long SYS_EPOLL_WAIT = 232;
+    static const long SYS_EPOLL_CTL = 233;
+    static const long SYS_ACCEPT4 = 288;
+    static const long SYS_EPOLL_CREATE1 = 291;
+    static const long AF_UNIX = 1;
+    static const long SOCK_STREAM = 1;
+    static const long SOCK_NONBLOCK = 04000;
+    static const long SOCK_CLOEXEC = 02000000;
+    static const long EPOLL_CLOEXEC = 02000000;
+    static const long MSG_NOSIGNAL = 0x4000;
+    static const long ERR_AGAIN = 11;
+    static const long ERR_INTR = 4;
+    static const int EPOLL_CTL_ADD = 1;
+    static const int EPOLL_CTL_DEL = 2;
+    static const int EPOLL_CTL_MOD = 3;
+    static const unsigned int EPOLLIN = 0x001;
+    static const unsigned int EPOLLOUT = 0x004;
+    static const unsigned int EPOLLERR = 0x008;
+    static const unsigned int EPOLLHUP = 0x010;
+    static const unsigned long LISTEN_TAG = ~0UL;
+    static const int REPLY_RESERVE = 256;   // longest single reply
+
+    struct __attribute__((packed)) EpollEvent {
+        unsigned int events;
+        unsigned long data;
+    };
+
+    struct Connection {
+        long fd;
+        long in_len;      // buffered request bytes
+        long out_len;     // reply bytes not yet sent
+        long out_sent;
+        bool blocked;     // waiting for EPOLLOUT
+        char in[IN_BYTES];
+        char out[OUT_BYTES];
+    };
+
+    const char* path;
+    ManagerSource source;
+    long listen_fd;
+    long epoll_fd;
+    bool running;
+    Stats stats;
+    Connection conns[MAX_CONNECTIONS];
+
+    bool watch(int op, long fd, unsigned int events, unsigned long tag) {
+        EpollEvent ev;
+        ev.events = events;
+        ev.data = tag;
+        return syscall6(SYS_EPOLL_CTL, epoll_fd, op, fd, (long)&ev, 0, 0) == 0;
+    }
+
+    void acceptAll() {
+        while (true) {
+            long fd = syscall6(SYS_ACCEPT4, listen_fd, 0, 0, SOCK_NONBLOCK | SOCK_CLOEXEC, 0, 0);
+            if (fd < 0) return;   // -EAGAIN: backlog drained
+            int slot = -1;
+            for (int i = 0; i < MAX_CONNECTIONS; ++i) {
+                if (conns[i].fd < 0) { slot = i; break; }
+            }
+            if (slot < 0 || !watch(EPOLL_CTL_ADD, fd, EPOLLIN, static_cast<unsigned long>(slot))) {
+                syscall3(SYS_CLOSE, fd, 0, 0);
+                continue;
+            }
+            Connection& c = conns[slot];
+            c.fd = fd;
+            c.in_len = c.out_len = c.out_sent = 0;
+            c.blocked = false;
+            ++stats.connections;
+        }
+    }
+
+    void drop(Connection& c) {
+        watch(EPOLL_CTL_DEL, c.fd, 0, 0);
+        syscall3(SYS_CLOSE, c.fd, 0, 0);
+        c.fd = -1;
+    }
+
+    void readAndServe(Connection& c) {
+        long n = syscall3(SYS_READ, c.fd, (long)(c.in + c.in_len), IN_BYTES - c.in_len);
+        if (n == -ERR_AGAIN) return;
+        if (n <= 0) {
+            drop(c);
+            return;
+        }
+        c.in_len += n;
+        serve(c);
+    }
+
+    // Executes every complete buffered line, then sends all replies at once.
+    // If the reply buffer fills first, it is flushed and parsing resumes.
+    void serve(Connection& c) {
+        while (c.fd >= 0) {
+            long pos = 0;
+            bool more = false;
+            while (true) {
+                if (c.out_len > OUT_BYTES - REPLY_RESERVE) { more = true; break; }
+                long end = pos;
+                while (end < c.in_len && c.in[end] != '\n') ++end;
+                if (end >= c.in_len) break;
+                OutBuffer reply(c.out + c.out_len, OUT_BYTES - c.out_len);
+                execute(c.in + pos, end - pos, reply);
+                c.out_len += reply.size();
+                pos = end + 1;
+            }
+            if (pos == 0 && c.in_len == IN_BYTES) {   // no newline in a full buffer
+                OutBuffer reply(c.out + c.out_len, OUT_BYTES - c.out_len);
+                reply.put("ERR LINE_TOO_LONG\n");
+                c.out_len += reply.size();
+                pos = c.in_len;
+                ++stats.errors;
+            }
+            for (long k = pos; k < c.in_len; ++k) c.in[k - pos] = c.in[k];
+            c.in_len -= pos;
+            if (!flush(c) || !more) return;
+        }
+    }
+
+    // Sends pending replies; false (and EPOLLOUT armed) if the socket is full
+    bool flush(Connection& c) {
+        while (c.out_sent < c.out_len) {
+            long n = syscall6(SYS_SENDTO, c.fd, (long)(c.out + c.out_sent), c.out_len - c.out_sent,
+                              MSG_NOSIGNAL, 0, 0);
+            if (n == -ERR_AGAIN) {
+                if (!c.blocked) watch(EPOLL_CTL_MOD, c.fd, EPOLLOUT, slotOf(c));
+                c.blocked = true;
+                return false;
+            }
+            if (n <= 0) {
+                drop(c);
+                return false;
+            }
+            ++stats.sends;
+            c.out_sent += n;
+        }
+        c.out_len = c.out_sent = 0;
+        if (c.blocked) {
+            watch(EPOLL_CTL_MOD, c.fd, EPOLLIN, slotOf(c));
+            c.blocked = false;
+        }
+        return true;
+    }
+
+    unsigned long slotOf(const Connection& c) const { return static_cast<unsigned long>(&c - conns); }
+
+    static const char* skipSpaces(const char* p, const char* end) {
+        while (p < end && (*p == ' ' || *p == '\t' || *p == '\r')) ++p;
+        return p;
+    }
+
+    // Largest field value: every field is narrowed to int
+    static const long MAX_FIELD = 0x7fffffffL;
+
+    // Next unsigned integer field; false if there is none or it passes MAX_FIELD
+    static bool nextInt(const char*& p, const char* end, long& value) {
+        p = skipSpaces(p, end);
+        if (p >= end || *p < '0' || *p > '9') return false;
+        value = 0;
+        while (p < end && *p >= '0' && *p <= '9') {
+            int digit = *p++ - '0';
+            if (value > (MAX_FIELD - digit) / 10) return false;   // checked before it can wrap
+            value = value * 10 + digit;
+        }
+        return true;
+    }
+
+    // Optional trailing field: value is left alone if absent, false if malformed
+    static bool optionalInt(const char*& p, const char* end, long& value) {
+        p = skipSpaces(p, end);
+        return p >= end || nextInt(p, end, value);
+    }
+
+    GenerationManager* managerFor(const char*& p, const char* end, OutBuffer& reply) {
+        long gen;
+        if (!nextInt(p, end, gen) || gen < NetworkConfig::MIN_GEN || gen > NetworkConfig::MAX_GEN) {
+            reply.put("ERR BAD_GEN\n");
+            return nullptr;
+        }
+        return source(static_cast<int>(gen));
+    }
+
+    void execute(const char* line, long len, OutBuffer& reply) {
+        ++stats.requests;
+        const char* end = line + len;
+        const char* p = skipSpaces(line, end);
+        if (p >= end) {
+            --stats.requests;   // blank line
+            return;
+        }
+        char cmd = *p;
+        bool shutdown = cmd == 'S' && p + 1 < end && p[1] == 'H';
+        while (p < end && *p != ' ' && *p != '\t') ++p;
+        long before = reply.size();
+
+        if (cmd == 'P') {
+            reply.put("OK\n");
+        } else if (shutdown) {
+            reply.put("OK\n");
+            running = false;
+        } else if (cmd == 'A') {
+            GenerationManager* m = managerFor(p, end, reply);
+            long service, freq, carriers = 1;
+            if (m && (!nextInt(p, end, service) || !nextInt(p, end, freq) || service < 1 || service > 4 ||
+                      !optionalInt(p, end, carriers))) {
+                reply.put("ERR USAGE ADD <gen> <service 1-4> <freq>\n");
+            } else if (m) {
+                int placed = 0;
+                GenerationManager::AdmitResult r = m->tryAddUserPlaced(static_cast<int>(service), static_cast<int>(freq),
+                                                                       placed, static_cast<int>(carriers));
+                if (r == GenerationManager::ADMIT_OK)
+                    reply.put("OK ").putInt(placed).put(' ').putInt(m->getUserCount()).put('\n');
+                else
+                    reply.put("ERR ").put(admitReason(r)).put('\n');
+            }
+        } else if (cmd == 'R') {
+            GenerationManager* m = managerFor(p, end, reply);
+            long id;
+            if (m && !nextInt(p, end, id)) {
+                reply.put("ERR USAGE REMOVE <gen> <user_id>\n");
+            } else if (m) {
+                if (id < 1 || id > m->getUserCount()) {
+                    reply.put("ERR NO_USER\n");
+                } else {
+                    m->removeUser(static_cast<int>(id));
+                    reply.put("OK\n");
+                }
+            }
+        } else if (cmd == 'Q') {
+            GenerationManager* m = managerFor(p, end, reply);
+            long freq, freq2 = -1;
+            if (m && (!nextInt(p, end, freq) || !optionalInt(p, end, freq2))) {
+                reply.put("ERR USAGE QUERY <gen> <freq>\n");
+            } else if (m) {
+                bool pair = freq2 >= 0;
+                int slot = m->findSlot(static_cast<int>(freq));
+                if (slot < 0 || (pair && m->findSlot(static_cast<int>(freq2)) < 0)) reply.put("ERR INVALID_FREQ\n");
+                else if (pair) reply.put("OK ").putInt(m->countUsersOnBoth(static_cast<int>(freq), static_cast<int>(freq2))).put('\n');
+                else reply.put("OK ").putInt(m->getSlotUsers(slot)).put('\n');
+            }
+        } else if (cmd == 'S') {
+            GenerationManager* m = managerFor(p, end, reply);
+            if (m) {
+                reply.put("OK users=").putInt(m->getUserCount())
+                     .put(" util=").putInt(m->getUtilisation())
+                     .put("% full=").putInt(m->getFullSlotCount()).put('/').putInt(m->getSlotCount())
+                     .put(" messages=").putInt(m->getTotalMessages())
+                     .put(" core=").putInt(m->getCoreLoad()).put('/').putInt(m->getCoreCapacity()).put('\n');
+            }
+        } else {
+            reply.put("ERR UNKNOWN_COMMAND\n");
+        }
+        if (reply.size() > before + 3 && reply.data()[before] == 'E') ++stats.errors;
+    }
+
+    static const char* admitReason(GenerationManager::AdmitResult r) {
+        if (r == GenerationManager::ADMIT_SLOT_FULL) return "SLOT_FULL";
+        if (r == GenerationManager::ADMIT_CORE_FULL) return "CORE_FULL";
+        if (r == GenerationManager::ADMIT_INVALID_FREQ) return "INVALID_FREQ";
+        return "USER_LIMIT";
+    }
+};
@@ -0,0 +1,314 @@
+#pragma once
+#include <atomic>
+#include <thread>
+#include "GenerationManager.h"
+#include "Topology.h"   // SpinBarrier
+#include "Perf.h"       // log-linear latency buckets
+
+// Fixed-capacity Chase-Lev work-stealing deque. The owner pushes and pops at
+// the bottom; any other thread may steal from the top. Only the owner may
+// push, and clear() is only safe while no thief is running.
+template<typename T>
+class StealDeque {
+public:
+    StealDeque() : buf(nullptr), mask(0), top(0), bottom(0) {}
+    ~StealDeque() { delete[] buf; }
+
+    StealDeque(const StealDeque&) = delete;
+    StealDeque& operator=(const StealDeque&) = delete;
+
+    void init(unsigned long capacity_pow2) {
+        delete[] buf;
+        buf = new T[capacity_pow2];
+        mask = capacity_pow2 - 1;
+        clear();
+    }
+
+    void clear() {
+        top.store(0, std::memory_order_relaxed);
+        bottom.store(0, std::memory_order_relaxed);
+    }
+
+    bool push(const T& value) {
+        long b = bottom.load(std::memory_order_relaxed);
+        long t = top.load(std::memory_order_acquire);
+        if (b - t > static_cast<long>(mask)) return false;
+        buf[b & mask] = value;
+        std::atomic_thread_fence(std::memory_order_release);
+        bottom.store(b + 1, std::memory_order_relaxed);
+        return true;
+    }
+
+    bool pop(T& value) {
+        long b = bottom.load(std::memory_order_relaxed) - 1;
+        bottom.store(b, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        long t = top.load(std::memory_order_relaxed);
+        if (t > b) {
+            bottom.store(b + 1, std::memory_order_relaxed);
+            return false;
+        }
+        value = buf[b & mask];
+        if (t < b) return true;
+        // Last element: race the thieves for it
+        bool won = top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+        bottom.store(b + 1, std::memory_order_relaxed);
+        return won;
+    }
+
+    bool steal(T& value) {
+        long t = top.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        long b = bottom.load(std::memory_order_acquire);
+        if (t >= b) return false;
+        value = buf[t & mask];
+        return top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+    }
+
+    long size() const {
+        long n = bottom.load(std::memory_order_relaxed) - top.load(std::memory_order_relaxed);
+        return n > 0 ? n : 0;
+    }
+
+private:
+    T* buf;
+    unsigned long mask;
+    alignas(64) std::atomic<long> top;
+    alignas(64) std::atomic<long> bottom;
+};
+
+// 🔥 Runtime message processing for a generation's cores. Each core is a
+// worker thread with a run queue of per-user jobs (one job = all of a
+// user's signalling messages for a round). Users are homed on the core that
+// serves their primary slot, so uneven slot loading leaves some queues deep
+// and others empty; an idle worker steals jobs from the top of a busy one's
+// queue. A message costs message_ns of CPU (busy-wait).
+//
+// A round delivers every job at once, as a burst, and ends when all are
+// done. Jobs are timed with the timestamp counter (Clock::ticks), so the
+// per-job clock reads add tens of nanoseconds rather than two syscalls. Latency is measured from the burst to each message's completion
+// (messages inside a job finish at evenly spaced points of its run).
+class CoreWorkers {
+public:
+    static const int MAX_WORKERS = 64;
+
+    struct Stats {
+        int workers;
+        int rounds;
+        long jobs;
+        long messages;
+        long stolen;          // jobs run by a core other than their home core
+        long max_depth;       // deepest run queue when a burst landed
+        double mean_depth;    // mean queue depth seen at each pop
+        long elapsed_ns;
+        long busy_ns;         // summed over workers: time spent processing messages
+        long p50_ns;          // per-message latency from the burst
+        long p90_ns;
+        long p99_ns;
+        long max_ns;
+        double msgs_per_sec;
+    };
+
+    CoreWorkers(int worker_count, long message_cost_ns)
+        : workers(worker_count < 1 ? 1 : (worker_count > MAX_WORKERS ? MAX_WORKERS : worker_count)),
+          message_ns(message_cost_ns < 0 ? 0 : message_cost_ns), message_ticks(0), total_jobs(0) {
+        for (int w = 0; w < MAX_WORKERS; ++w) {
+            jobs[w] = nullptr;
+            job_count[w] = 0;
+            job_cap[w] = 0;
+        }
+        queues = new StealDeque<Job>[workers];
+    }
+
+    ~CoreWorkers() {
+        for (int w = 0; w < workers; ++w) delete[] jobs[w];
+        delete[] queues;
+    }
+
+    CoreWorkers(const CoreWorkers&) = delete;
+    CoreWorkers& operator=(const CoreWorkers&) = delete;
+
+    void clear() {
+        for (int w = 0; w < workers; ++w) job_count[w] = 0;
+        total_jobs = 0;
+    }
+
+    // Home core of a slot
+    int coreFor(int slot_idx) const { return slot_idx % workers; }
+
+    void addJob(int core, int messages) {
+        if (job_count[core] == job_cap[core]) grow(core);
+        jobs[core][job_count[core]++] = Job{messages};
+        ++total_jobs;
+    }
+
+    // One job per current user, homed by primary slot
+    long loadManager(const GenerationManager& manager) {
+        clear();
+        for (int i = 0; i < manager.getUserCount(); ++i) {
+            const UserDevice& u = manager.getUser(i);
+            int slot = manager.findSlot(u.getFrequency());
+            addJob(coreFor(slot < 0 ? 0 : slot), u.getMessages());
+        }
+        return total_jobs;
+    }
+
+    // The load getCoresNeededForFull() assumes: Max Users (Spectrum) users at
+    // the profile's messages per user, spread evenly over the slots
+    long loadFull(const GenerationManager& manager) {
+        clear();
+        long n = manager.getMaxUsersBySpectrum();
+        int slots = manager.getSlotCount();
+        for (long i = 0; i < n; ++i)
+            addJob(coreFor(static_cast<int>(i * slots / n)), manager.getMessagesPerUser());
+        return total_jobs;
+    }
+
+    Stats run(int rounds, bool stealing = true) {
+        if (rounds < 1) rounds = 1;
+        long deepest = 1;
+        for (int w = 0; w < workers; ++w)
+            if (job_count[w] > deepest) deepest = job_count[w];
+        unsigned long capacity = 1;
+        while (capacity < static_cast<unsigned long>(deepest)) capacity <<= 1;
+        for (int w = 0; w < workers; ++w) queues[w].init(capacity);
+
+        Counters* per_worker = new Counters[workers]();
+        std::atomic<long> remaining(0);
+        long burst = 0;
+        message_ticks = Clock::nsToTicks(message_ns);   // calibrates the counter before the clock starts
+        SpinBarrier barrier(workers);
+        long start = Clock::nowNs();
+        std::thread threads[MAX_WORKERS];
+        for (int p = 0; p < workers; ++p) {
+            threads[p] = std::thread([this, p, rounds, stealing, &barrier, &remaining, &burst, per_worker]() {
+                Counters& c = per_worker[p];
+                unsigned long rng = 0x9e3779b97f4a7c15UL * static_cast<unsigned long>(p + 1);
+                for (int r = 0; r < rounds; ++r) {
+                    queues[p].clear();
+                    for (long k = 0; k < job_count[p]; ++k) queues[p].push(jobs[p][k]);
+                    if (job_count[p] > c.max_depth) c.max_depth = job_count[p];
+                    if (p == 0) remaining.store(total_jobs, std::memory_order_relaxed);
+                    barrier.wait();
+                    if (p == 0) burst = Clock::ticks();
+                    barrier.wait();
+                    Job job;
+                    while (remaining.load(std::memory_order_acquire) > 0) {
+                        long depth = queues[p].size();
+                        if (queues[p].pop(job)) {
+                            c.depth_sum += depth;
+                            ++c.pops;
+                        } else if (stealing && steal(p, rng, job)) {
+                            ++c.stolen;
+                        } else {
+                            std::this_thread::yield();
+                            continue;
+                        }
+                        execute(job, burst, c);
+                        remaining.fetch_sub(1, std::memory_order_acq_rel);
+                    }
+                    barrier.wait();
+                }
+            });
+        }
+        for (int p = 0; p < workers; ++p) threads[p].join();
+
+        Stats s = {};
+        s.workers = workers;
+        s.rounds = rounds;
+        s.elapsed_ns = Clock::nowNs() - start;
+        long buckets[Perf::BUCKETS];
+        for (int b = 0; b < Perf::BUCKETS; ++b) buckets[b] = 0;
+        long pops = 0, depth_sum = 0;
+        for (int p = 0; p < workers; ++p) {
+            const Counters& c = per_worker[p];
+            s.jobs += c.jobs;
+            s.messages += c.messages;
+            s.stolen += c.stolen;
+            s.busy_ns += c.busy_ns;
+            if (c.max_depth > s.max_depth) s.max_depth = c.max_depth;
+            if (c.max_latency > s.max_ns) s.max_ns = c.max_latency;
+            pops += c.pops;
+            depth_sum += c.depth_sum;
+            for (int b = 0; b < Perf::BUCKETS; ++b) buckets[b] += c.hist[b];
+        }
+        delete[] per_worker;
+        s.mean_depth = pops > 0 ? static_cast<double>(depth_sum) / pops : 0.0;
+        s.p50_ns = Perf::percentile(buckets, s.messages, 50);
+        s.p90_ns = Perf::percentile(buckets, s.messages, 90);
+        s.p99_ns = Perf::percentile(buckets, s.messages, 99);
+        s.msgs_per_sec = s.elapsed_ns > 0 ? s.messages * 1e9 / s.elapsed_ns : 0.0;
+        return s;
+    }
+
+    int getWorkerCount() const { return workers; }
+    long getJobCount() const { return total_jobs; }
+    long getQueuedJobs(int core) const { return job_count[core]; }
+
+private:
+    struct Job {
+        int messages;
+    };
+
+    struct Counters {
+        long jobs;
+        long messages;
+        long stolen;
+        long busy_ns;
+        long max_depth;
+        long depth_sum;
+        long pops;
+        long max_latency;
+        long hist[Perf::BUCKETS];
+    };
+
+    int workers;
+    long message_ns;
+    long message_ticks;
+    Job* jobs[MAX_WORKERS];       // each core's jobs for one round
+    long job_count[MAX_WORKERS];
+    long job_cap[MAX_WORKERS];
+    long total_jobs;
+    StealDeque<Job>* queues;
+
+    void grow(int core) {
+        long cap = job_cap[core] > 0 ? job_cap[core] * 2 : 256;
+        Job* bigger = new Job[cap];
+        for (long k = 0; k < job_count[core]; ++k) bigger[k] = jobs[core][k];
+        delete[] jobs[core];
+        jobs[core] = bigger;
+        job_cap[core] = cap;
+    }
+
+    // Tries every other queue once, starting at a random victim
+    bool steal(int self, unsigned long& rng, Job& job) {
+        if (workers == 1) return false;
+        rng ^= rng << 13;
+        rng ^= rng >> 7;
+        rng ^= rng << 17;
+        int first = static_cast<int>(rng % static_cast<unsigned long>(workers));
+        for (int k = 0; k < workers; ++k) {
+            int victim = (first + k) % workers;
+            if (victim != self && queues[victim].steal(job)) return true;
+        }
+        return false;
+    }
+
+    // Times are in ticks from `burst` until converted for the counters
+    void execute(const Job& job, long burst, Counters& c) {
+        long begin = Clock::ticks();
+        long until = begin + job.messages * message_ticks;
+        long end = begin;
+        while (end < until) end = Clock::ticks();
+        if (message_ticks == 0) end = Clock::ticks();
+        c.busy_ns += Clock::ticksToNs(end - begin);
+        ++c.jobs;
+        c.messages += job.messages;
+        for (int m = 1; m <= job.messages; ++m) {
+            long latency = Clock::ticksToNs(begin + (end - begin) * m / job.messages - burst);
+            if (latency < 0) latency = 0;
+            ++c.hist[Perf::bucketOf(static_cast<unsigned long>(latency))];
+            if (latency > c.max_latency) c.max_latency = latency;
+        }
+    }
+};
@@ -0,0 +1,419 @@
+#pragma once
+#include <thread>
+#include "NetworkConfig.h"
+#include "Clock.h"
+
+// Uniform-grid index over tower sites. Sites are bucketed into square cells
+// (about two sites per cell) and stored cell by cell, so a nearest-site
+// query scans the query's cell and then rings of neighbouring cells until
+// no closer site can exist. Each site also keeps half the distance to its
+// nearest neighbour: a point within that radius of a site is served by it,
+// so a move that stays inside its serving site's radius costs one distance
+// check and larger moves start the ring search bounded by the old site.
+class SiteIndex {
+public:
+    SiteIndex()
+        : cols(0), rows(0), cell_m(1), min_x(0), min_y(0), site_count(0),
+          cell_start(nullptr), ids(nullptr), xs(nullptr), ys(nullptr), site_x(nullptr), site_y(nullptr),
+          safe2(nullptr) {}
+    ~SiteIndex() { release(); }
+
+    SiteIndex(const SiteIndex&) = delete;
+    SiteIndex& operator=(const SiteIndex&) = delete;
+
+    void build(const float* x, const float* y, int n) {
+        release();
+        site_count = n;
+        if (n == 0) return;
+        float max_x = x[0], max_y = y[0];
+        min_x = x[0];
+        min_y = y[0];
+        for (int i = 1; i < n; ++i) {
+            if (x[i] < min_x) min_x = x[i];
+            if (y[i] < min_y) min_y = y[i];
+            if (x[i] > max_x) max_x = x[i];
+            if (y[i] > max_y) max_y = y[i];
+        }
+        float w = max_x - min_x, h = max_y - min_y;
+        float area = (w > 1 ? w : 1) * (h > 1 ? h : 1);
+        cell_m = __builtin_sqrtf(2.0f * area / n);
+        if (cell_m < 1) cell_m = 1;
+        cols = static_cast<int>(w / cell_m) + 1;
+        rows = static_cast<int>(h / cell_m) + 1;
+
+        // Counting sort of the sites by cell
+        cell_start = new int[static_cast<long>(cols) * rows + 1]();
+        int* cell_of = new int[n];
+        for (int i = 0; i < n; ++i) {
+            cell_of[i] = cellIndex(x[i], y[i]);
+            ++cell_start[cell_of[i] + 1];
+        }
+        for (long c = 0; c < static_cast<long>(cols) * rows; ++c) cell_start[c + 1] += cell_start[c];
+        int* fill = new int[static_cast<long>(cols) * rows];
+        for (long c = 0; c < static_cast<long>(cols) * rows; ++c) fill[c] = cell_start[c];
+        ids = new int[n];
+        xs = new float[n];
+        ys = new float[n];
+        site_x = new float[n];
+        site_y = new float[n];
+        for (int i = 0; i < n; ++i) {
+            int k = fill[cell_of[i]]++;
+            ids[k] = i;
+            xs[k] = x[i];
+            ys[k] = y[i];
+            site_x[i] = x[i];
+            site_y[i] = y[i];
+        }
+        delete[] fill;
+        delete[] cell_of;
+        safe2 = new float[n];
+        for (int i = 0; i < n; ++i) {
+            float d2 = 3.4e38f;
+            if (search(x[i], y[i], -1, i, &d2) < 0) d2 = 3.4e38f;
+            safe2[i] = d2 < 3.4e38f ? d2 / 4 : d2;
+        }
+    }
+
+    // Nearest site to (px, py); `hint`, if >= 0, is a site known to be close.
+    // Returns -1 only when there are no sites.
+    int nearest(float px, float py, int hint = -1, float* dist2 = nullptr) const {
+        if (site_count == 0) return -1;
+        if (hint >= 0) {
+            float d2 = siteDist2(hint, px, py);
+            if (d2 < safe2[hint]) {
+                if (dist2) *dist2 = d2;
+                return hint;
+            }
+        }
+        return search(px, py, hint, -1, dist2);
+    }
+
+    int getSiteCount() const { return site_count; }
+    float getCellSize() const { return cell_m; }
+
+private:
+    int cols;
+    int rows;
+    float cell_m;
+    float min_x;
+    float min_y;
+    int site_count;
+    int* cell_start;   // CSR offsets, cols * rows + 1
+    int* ids;          // site index, in cell order
+    float* xs;         // site coordinates, in cell order
+    float* ys;
+    float* site_x;     // site coordinates by site index
+    float* site_y;
+    float* safe2;      // (nearest-neighbour distance / 2)^2 by site index
+
+    // Ring search; `exclude` skips one site (used to find neighbours)
+    int search(float px, float py, int hint, int exclude, float* dist2) const {
+        int best = -1;
+        float best_d2 = 3.4e38f;
+        if (hint >= 0) {
+            best = hint;
+            best_d2 = siteDist2(hint, px, py);
+        }
+        int cx = clampCol(px), cy = clampRow(py);
+        int max_ring = cols > rows ? cols : rows;
+        for (int r = 0; r <= max_ring; ++r) {
+            for (int gy = cy - r; gy <= cy + r; ++gy) {
+                if (gy < 0 || gy >= rows) continue;
+                bool edge_row = gy == cy - r || gy == cy + r;
+                int step = edge_row || r == 0 ? 1 : 2 * r;   // interior rows: only the two ring columns
+                for (int gx = cx - r; gx <= cx + r; gx += step) {
+                    if (gx < 0 || gx >= cols) continue;
+                    long c = static_cast<long>(gy) * cols + gx;
+                    for (int k = cell_start[c]; k < cell_start[c + 1]; ++k) {
+                        if (ids[k] == exclude) continue;
+                        float dx = xs[k] - px, dy = ys[k] - py;
+                        float d2 = dx * dx + dy * dy;
+                        if (d2 < best_d2 || (d2 == best_d2 && ids[k] < best)) {
+                            best_d2 = d2;
+                            best = ids[k];
+                        }
+                    }
+                }
+            }
+            // Everything in ring r + 1 is at least r cells away
+            float reach = r * cell_m;
+            if (best >= 0 && best_d2 <= reach * reach) break;
+        }
+        if (dist2) *dist2 = best_d2;
+        return best;
+    }
+
+    int clampCol(float px) const {
+        float f = (px - min_x) / cell_m;
+        return f < 0 ? 0 : (f >= cols ? cols - 1 : static_cast<int>(f));
+    }
+    int clampRow(float py) const {
+        float f = (py - min_y) / cell_m;
+        return f < 0 ? 0 : (f >= rows ? rows - 1 : static_cast<int>(f));
+    }
+    int cellIndex(float px, float py) const { return clampRow(py) * cols + clampCol(px); }
+
+    float siteDist2(int site, float px, float py) const {
+        float dx = site_x[site] - px, dy = site_y[site] - py;
+        return dx * dx + dy * dy;
+    }
+
+    void release() {
+        delete[] cell_start;
+        delete[] ids;
+        delete[] xs;
+        delete[] ys;
+        delete[] site_x;
+        delete[] site_y;
+        delete[] safe2;
+        cell_start = nullptr;
+        ids = nullptr;
+        xs = nullptr;
+        ys = nullptr;
+        site_x = nullptr;
+        site_y = nullptr;
+        safe2 = nullptr;
+        site_count = 0;
+    }
+};
+
+// 🔥 City-scale coverage for one generation: tower sites on a jittered grid
+// with a given inter-site distance, users with positions, and each user's
+// serving site (the nearest one). Site capacity is the generation's whole
+// band plan, so sites over capacity are the hotspots.
+//
+// Bulk assignment splits the users into contiguous ranges, one worker thread
+// each. Workers write only their own users' serving sites and adjust the
+// shared site counts with relaxed atomic increments, so the extra memory is
+// independent of the thread and site counts. A move re-queries the index
+// with the current site as the starting bound and adjusts two site counts.
+// Nothing is rebuilt.
+class Coverage {
+public:
+    static const int MAX_THREADS = 64;
+
+    struct Stats {
+        long users;
+        long handovers;       // users whose serving site changed
+        long out_of_range;    // farther than one inter-site distance from every site
+        int overloaded;       // sites over capacity
+        int busiest;          // site with the most users
+        long elapsed_us;
+    };
+
+    Coverage(int gen, int sites, float site_spacing_m, unsigned long seed = 42)
+        : generation(gen), site_count(sites < 1 ? 1 : sites), spacing(site_spacing_m < 1 ? 1 : site_spacing_m),
+          site_capacity(0), site_x(nullptr), site_y(nullptr), site_load(nullptr),
+          user_x(nullptr), user_y(nullptr), serving(nullptr), user_count(0), user_capacity(0) {
+        const NetworkConfig& cfg = NetworkConfig::profile(gen);
+        for (int b = 0; b < cfg.band_count; ++b) site_capacity += cfg.bands[b].count * cfg.bands[b].max_users;
+
+        // Square-ish grid, each site jittered by up to 30% of the spacing
+        grid_cols = 1;
+        while (static_cast<long>(grid_cols) * grid_cols < site_count) ++grid_cols;
+        site_x = new float[site_count];
+        site_y = new float[site_count];
+        site_load = new long[site_count]();
+        for (int s = 0; s < site_count; ++s) {
+            unsigned long h = hash(seed, s);
+            site_x[s] = (s % grid_cols + 0.5f + 0.6f * (unit(h) - 0.5f)) * spacing;
+            site_y[s] = (s / grid_cols + 0.5f + 0.6f * (unit(h >> 24) - 0.5f)) * spacing;
+        }
+        grid_rows = (site_count + grid_cols - 1) / grid_cols;
+        index.build(site_x, site_y, site_count);
+    }
+
+    ~Coverage() {
+        delete[] site_x;
+        delete[] site_y;
+        delete[] site_load;
+        delete[] user_x;
+        delete[] user_y;
+        delete[] serving;
+    }
+
+    Coverage(const Coverage&) = delete;
+    Coverage& operator=(const Coverage&) = delete;
+
+    // Places n users over the city area: hotspot_pct of them cluster around
+    // ~1% of the sites (about one spacing across), the rest are uniform.
+    // Positions depend only on the seed and the user number.
+    void populate(long n, int hotspot_pct, int threads, unsigned long seed = 7) {
+        reserve(n);
+        user_count = n;
+        float width = grid_cols * spacing, height = grid_rows * spacing;
+        int hot = site_count / 100 > 0 ? site_count / 100 : 1;
+        parallelFor(n, threads, [&](long begin, long end, int) {
+            for (long u = begin; u < end; ++u) {
+                unsigned long h = hash(seed, u);
+                if (static_cast<int>(h % 100) < hotspot_pct) {
+                    int centre = static_cast<int>((h >> 8) % hot) * (site_count / hot);
+                    unsigned long g = hash(seed + 1, u);
+                    user_x[u] = site_x[centre] + spacing * (gauss(g) * 0.5f);
+                    user_y[u] = site_y[centre] + spacing * (gauss(g >> 32) * 0.5f);
+                } else {
+                    user_x[u] = width * unit(h >> 8);
+                    user_y[u] = height * unit(h >> 32);
+                }
+                serving[u] = -1;
+            }
+        });
+    }
+
+    // Serving site of every user from scratch, on `threads` workers
+    Stats assignAll(int threads) {
+        long start = Clock::nowNs();
+        Stats s = sweep(threads, [](long, float&, float&) {}, false);
+        s.elapsed_us = Clock::elapsedUs(start);
+        return s;
+    }
+
+    // Every user takes one random-walk step of up to step_m in each axis and
+    // keeps or changes its serving site incrementally
+    Stats moveAll(float step_m, int threads, unsigned long seed) {
+        long start = Clock::nowNs();
+        Stats s = sweep(threads, [this, step_m, seed](long u, float& x, float& y) {
+            unsigned long h = hash(seed, u);
+            x += step_m * (2.0f * unit(h) - 1.0f);
+            y += step_m * (2.0f * unit(h >> 32) - 1.0f);
+        }, true);
+        s.elapsed_us = Clock::elapsedUs(start);
+        return s;
+    }
+
+    // Moves one user; returns its serving site
+    int moveUser(long u, float x, float y) {
+        user_x[u] = x;
+        user_y[u] = y;
+        int site = index.nearest(x, y, serving[u]);
+        if (site != serving[u]) {
+            if (serving[u] >= 0) --site_load[serving[u]];
+            ++site_load[site];
+            serving[u] = site;
+        }
+        return site;
+    }
+
+    int getGeneration() const { return generation; }
+    int getSiteCount() const { return site_count; }
+    float getSpacing() const { return spacing; }
+    long getSiteCapacity() const { return site_capacity; }
+    long getSiteLoad(int s) const { return site_load[s]; }
+    float getSiteX(int s) const { return site_x[s]; }
+    float getSiteY(int s) const { return site_y[s]; }
+    long getUserCount() const { return user_count; }
+    int getServingSite(long u) const { return serving[u]; }
+    float getUserX(long u) const { return user_x[u]; }
+    float getUserY(long u) const { return user_y[u]; }
+    const SiteIndex& getIndex() const { return index; }
+
+private:
+    int generation;
+    int site_count;
+    float spacing;
+    int grid_cols;
+    int grid_rows;
+    long site_capacity;
+    float* site_x;
+    float* site_y;
+    long* site_load;
+    float* user_x;
+    float* user_y;
+    int* serving;
+    long user_count;
+    long user_capacity;
+    SiteIndex index;
+
+    void reserve(long n) {
+        if (n <= user_capacity) return;
+        delete[] user_x;
+        delete[] user_y;
+        delete[] serving;
+        user_x = new float[n];
+        user_y = new float[n];
+        serving = new int[n];
+        user_capacity = n;
+        for (int s = 0; s < site_count; ++s) site_load[s] = 0;
+    }
+
+    // Runs fn(begin, end, worker) over [0, n) in contiguous ranges
+    template<typename Fn>
+    static void parallelFor(long n, int threads, Fn fn) {
+        if (threads < 1) threads = 1;
+        if (threads > MAX_THREADS) threads = MAX_THREADS;
+        if (threads > n) threads = n > 0 ? static_cast<int>(n) : 1;
+        if (threads == 1) {
+            fn(0, n, 0);
+            return;
+        }
+        std::thread workers[MAX_THREADS];
+        for (int t = 0; t < threads; ++t) {
+            long begin = n * t / threads, end = n * (t + 1) / threads;
+            workers[t] = std::thread([&fn, begin, end, t]() { fn(begin, end, t); });
+        }
+        for (int t = 0; t < threads; ++t) workers[t].join();
+    }
+
+    // Moves (optionally) and re-serves every user. Only users that change
+    // site touch site_load, atomically when more than one worker shares it.
+    template<typename Move>
+    Stats sweep(int threads, Move move, bool use_hint) {
+        if (threads < 1) threads = 1;
+        if (threads > MAX_THREADS) threads = MAX_THREADS;
+        bool shared = threads > 1 && user_count > 1;
+        long handovers[MAX_THREADS] = {};
+        long far[MAX_THREADS] = {};
+        float range2 = spacing * spacing;
+        parallelFor(user_count, threads, [&](long begin, long end, int t) {
+            long moved = 0, beyond = 0;
+            for (long u = begin; u < end; ++u) {
+                move(u, user_x[u], user_y[u]);
+                int old = serving[u];
+                float d2 = 0;
+                int site = index.nearest(user_x[u], user_y[u], use_hint ? old : -1, &d2);
+                beyond += d2 > range2;
+                if (site == old) continue;
+                if (old >= 0) {
+                    addLoad(old, -1, shared);
+                    ++moved;
+                }
+                addLoad(site, 1, shared);
+                serving[u] = site;
+            }
+            handovers[t] = moved;
+            far[t] = beyond;
+        });
+        Stats s = {};
+        s.users = user_count;
+        for (int t = 0; t < MAX_THREADS; ++t) {
+            s.handovers += handovers[t];
+            s.out_of_range += far[t];
+        }
+        for (int site = 0; site < site_count; ++site) {
+            if (site_load[site] > site_capacity) ++s.overloaded;
+            if (site_load[site] > site_load[s.busiest]) s.busiest = site;
+        }
+        return s;
+    }
+
+    void addLoad(int site, long n, bool shared) {
+        if (shared) __atomic_fetch_add(&site_load[site], n, __ATOMIC_RELAXED);
+        else site_load[site] += n;
+    }
+
+    static unsigned long hash(unsigned long seed, long i) {
+        unsigned long x = seed * 0x9E3779B97F4A7C15UL + static_cast<unsigned long>(i);
+        x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9UL;
+        x = (x ^ (x >> 27)) * 0x94D049BB133111EBUL;
+        return x ^ (x >> 31);
+    }
+
+    static float unit(unsigned long x) { return static_cast<float>(x & 0xFFFFFF) / 16777216.0f; }
+
+    // Unit-variance Gaussian from four 8-bit uniforms (Irwin-Hall)
+    static float gauss(unsigned long x) {
+        float sum = 0;
+        for (int k = 0; k < 4; ++k) sum += static_cast<float>((x >> (8 * k)) & 0xFF) / 256.0f;
+        return (sum - 2.0f) * 1.7320508f;
+    }
+};
@@ -0,0 +1,142 @@
+#pragma once
+#include "GenerationManager.h"
+#include "OutBuffer.h"
+#include "Clock.h"
+
+// 🔥 Live utilisation table for watch mode. Every frame is rendered into a
+// grid of fixed-width cells and compared with the previous frame; only the
+// cells that changed are emitted, each behind an ANSI cursor move, and the
+// whole frame leaves in a single write syscall. A steady state costs a few
+// bytes per frame, so high refresh rates stay cheap.
+class Dashboard {
+public:
+    static const int MAX_ENGINES = 24;   // engine rows shown
+    static const int COLS = 7;
+
+    Dashboard() : out(frame, sizeof(frame)), first(true) {}
+
+    // Redraws the table for `n` engines plus a status line; returns bytes written
+    long draw(const GenerationManager* const* managers, int n, const char* status) {
+        out.clear();
+        if (first) {
+            out.put("\x1b[2J\x1b[H\x1b[?25l");   // clear, home, hide cursor
+            out.put("=== Live Utilisation ===");
+            for (int r = 0; r < ROWS; ++r) {
+                for (int c = 0; c < COLS; ++c) {
+                    prev[r][c][0] = '\x01';   // matches no text: forces a full draw
+                    prev[r][c][1] = '\0';
+                }
+            }
+            prev_status[0] = '\x01';
+            prev_status[1] = '\0';
+        }
+
+        static const char* headers[COLS] = {"Tech", "Users", "Util", "Full slots", "Messages", "Core load", "Core"};
+        for (int c = 0; c < COLS; ++c) setCell(0, c, headers[c]);
+        if (n > MAX_ENGINES) n = MAX_ENGINES;
+        for (int r = 0; r < MAX_ENGINES; ++r) {
+            if (r >= n) {
+                for (int c = 0; c < COLS; ++c) setCell(r + 1, c, "");
+                continue;
+            }
+            const GenerationManager& m = *managers[r];
+            char text[CELL_CHARS];
+            setCell(r + 1, 0, m.getTechName());
+            format(text, m.getUserCount(), -1, nullptr);
+            setCell(r + 1, 1, text);
+            format(text, m.getUtilisation(), -1, "%");
+            setCell(r + 1, 2, text);
+            format(text, m.getFullSlotCount(), m.getSlotCount(), nullptr);
+            setCell(r + 1, 3, text);
+            format(text, m.getTotalMessages(), -1, nullptr);
+            setCell(r + 1, 4, text);
+            format(text, m.getCoreLoad(), m.getCoreCapacity(), nullptr);
+            setCell(r + 1, 5, text);
+            long cap = m.getCoreCapacity();
+            format(text, cap > 0 ? (m.getCoreLoad() * 100) / cap : 0, -1, "%");
+            setCell(r + 1, 6, text);
+        }
+        if (!equals(prev_status, status, STATUS_CHARS - 1)) {
+            moveTo(ROWS + 3, 1);
+            int old_len = 0;
+            while (prev_status[old_len]) ++old_len;
+            int len = 0;
+            for (; status[len] && len < STATUS_CHARS - 1; ++len) {
+                prev_status[len] = status[len];
+                out.put(status[len]);
+            }
+            prev_status[len] = '\0';
+            for (int k = len; k < old_len; ++k) out.put(' ');   // erase a longer previous line
+        }
+        first = false;
+        long bytes = out.size();
+        out.flush(1);
+        return bytes;
+    }
+
+    // Leaves the cursor below the table and shows it again
+    void finish() {
+        out.clear();
+        moveTo(ROWS + 4, 1);
+        out.put("\x1b[?25h\n");
+        out.flush(1);
+        first = true;
+    }
+
+    static void sleepUntil(long deadline_ns) {
+        long wait = deadline_ns - Clock::nowNs();
+        if (wait <= 0) return;
+        struct { long sec; long nsec; } ts = {wait / 1000000000L, wait % 1000000000L};
+        syscall3(35, (long)&ts, 0, 0); // SYS_nanosleep
+    }
+
+private:
+    static const int ROWS = MAX_ENGINES + 1;   // header + engines
+    static const int CELL_CHARS = 16;
+    static const int STATUS_CHARS = 80;
+    static constexpr int WIDTHS[COLS] = {8, 10, 7, 14, 12, 16, 6};
+
+    char frame[16384];
+    OutBuffer out;
+    bool first;
+    char prev[ROWS][COLS][CELL_CHARS];
+    char prev_status[STATUS_CHARS];
+
+    void setCell(int row, int col, const char* text) {
+        int limit = WIDTHS[col] - 1 < CELL_CHARS - 1 ? WIDTHS[col] - 1 : CELL_CHARS - 1;
+        if (equals(prev[row][col], text, limit)) return;
+        int x = 1;
+        for (int c = 0; c < col; ++c) x += WIDTHS[c];
+        moveTo(row + 2, x);   // row 1 is the title
+        int len = 0;
+        for (; text[len] && len < limit; ++len) {
+            prev[row][col][len] = text[len];
+            out.put(text[len]);
+        }
+        prev[row][col][len] = '\0';
+        for (int k = len; k < WIDTHS[col]; ++k) out.put(' ');
+    }
+
+    void moveTo(int row, int col) {
+        out.put("\x1b[").putInt(row).put(';').putInt(col).put('H');
+    }
+
+    // Compares `a` with `b` truncated to `limit` characters
+    static bool equals(const char* a, const char* b, int limit) {
+        int i = 0;
+        while (i < limit && a[i] && a[i] == b[i]) ++i;
+        return i == limit ? a[i] == '\0' : a[i] == b[i];
+    }
+
+    // "value", "value/total" (total >= 0) or "value<suffix>"
+    static void format(char* text, long value, long total, const char* suffix) {
+        char storage[CELL_CHARS];
+        OutBuffer cell(storage, CELL_CHARS - 1);
+        cell.putInt(value);
+        if (total >= 0) cell.put('/').putInt(total);
+        if (suffix) cell.put(suffix);
+        long len = cell.size();
+        for (long k = 0; k < len; ++k) text[k] = storage[k];
+        text[len] = '\0';
+    }
+};
@@ -0,0 +1,74 @@
+#pragma once
+#include "GenerationManager.h"
+#include "NetworkConfig.h"
+
+// 🔥 Inter-generation fallback admission. A user rejected for capacity (slot,
+// core or user-table full) is offered to the profile's fallback generation,
+// then its fallback, and so on. Every hop is a plain tryAddUser* call, so a
+// rejection costs O(1); the config loader rejects cyclic chains, so each
+// generation is offered the user at most once.
+class FallbackChain {
+public:
+    struct Counters {
+        long offered;   // attempts at this generation (first choice + overflow from above)
+        long carried;   // admitted here
+        long overflow;  // passed on to the next generation (or lost at the end)
+    };
+
+    // Supplies (and lazily creates) the manager for a generation
+    typedef GenerationManager* (*ManagerSource)(int gen);
+
+    explicit FallbackChain(ManagerSource src) : source(src), enabled(false) { reset(); }
+
+    void reset() {
+        for (int g = 0; g <= NetworkConfig::MAX_GEN; ++g) {
+            counters[g].offered = 0;
+            counters[g].carried = 0;
+            counters[g].overflow = 0;
+        }
+        lost = 0;
+    }
+
+    // Returns the generation that carried the user (0 if lost). result_out is
+    // the first generation's own verdict, so callers can still report it.
+    // Each generation clamps `carriers` to its own aggregation limit.
+    int admit(int gen, int service_type, int freq, int& freq_out,
+              GenerationManager::AdmitResult& result_out, int carriers = 1) {
+        GenerationManager* m = source(gen);
+        result_out = m->tryAddUserPlaced(service_type, freq, freq_out, carriers);
+        if (result_out == GenerationManager::ADMIT_INVALID_FREQ) return 0;
+        ++counters[gen].offered;
+        if (result_out == GenerationManager::ADMIT_OK) {
+            ++counters[gen].carried;
+            return gen;
+        }
+        ++counters[gen].overflow;
+        if (!enabled) {
+            ++lost;
+            return 0;
+        }
+
+        // Lower generations use their own band plans, so placement is automatic there
+        for (int g = NetworkConfig::profile(gen).fallback_gen; g != 0; g = NetworkConfig::profile(g).fallback_gen) {
+            ++counters[g].offered;
+            if (source(g)->tryAddUserAuto(service_type, freq_out, carriers) == GenerationManager::ADMIT_OK) {
+                ++counters[g].carried;
+                return g;
+            }
+            ++counters[g].overflow;
+        }
+        ++lost;
+        return 0;
+    }
+
+    void setEnabled(bool on) { enabled = on; }
+    bool isEnabled() const { return enabled; }
+    const Counters& get(int gen) const { return counters[gen]; }
+    long getLost() const { return lost; }
+
+private:
+    ManagerSource source;
+    bool enabled;
+    Counters counters[NetworkConfig::MAX_GEN + 1];
+    long lost;
+};
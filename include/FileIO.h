@@ -0,0 +1,418 @@
+#pragma once
+#include "basicIO.h"
+
+// 🔥 File I/O layer for loading input files and writing saves. The default
+// backend is io_uring, driven through raw syscalls like the rest of the
+// project: loads keep several 1MB reads in flight and hand each completed
+// run of whole lines to the caller, so parsing overlaps with the disk; saves
+// submit all their 1MB writes in one batch. If io_uring cannot be set up
+// (old kernel, seccomp) or is disabled, the same calls fall back to plain
+// read/write loops.
+//
+// Saves are crash-safe: saveAtomic() writes a temp file, fsyncs it and
+// renames it over the target, so a crash leaves either the old file or the
+// new one. Text snapshots can carry a "# crc32 xxxxxxxx" trailer line (a
+// comment to the input parser) so damage or hand edits are detected on load.
+class FileIO {
+public:
+    static const long CHUNK = 1L << 20;
+    static const int DEPTH = 8;   // reads/writes in flight
+
+    enum Backend { BACKEND_SYNC, BACKEND_URING };
+
+    static void setUringEnabled(bool enabled) { ring().disabled = !enabled; }
+
+    static Backend backend() { return ring().ready() ? BACKEND_URING : BACKEND_SYNC; }
+
+    static const char* backendName() { return backend() == BACKEND_URING ? "io_uring" : "sync"; }
+
+    // Reads the whole file into a new[] buffer (NUL-terminated, caller frees)
+    // and calls on_lines(data, len) with consecutive runs of complete lines as
+    // soon as they are on hand. Returns nullptr if the file cannot be read.
+    template<typename Fn>
+    static char* load(const char* path, long& bytes, Fn on_lines) {
+        bytes = 0;
+        long fd = syscall3(SYS_OPEN, (long)path, O_RDONLY, 0);
+        if (fd < 0) return nullptr;
+        long size = syscall3(SYS_LSEEK, fd, 0, SEEK_END);
+        if (size < 0 || syscall3(SYS_LSEEK, fd, 0, SEEK_SET) < 0) {
+            syscall3(SYS_CLOSE, fd, 0, 0);
+            return nullptr;
+        }
+        char* buf = new char[size + 1];
+        long parsed = 0;
+        bool ok = ring().ready() ? loadUring(fd, buf, size, parsed, on_lines)
+                                 : loadSync(fd, buf, size, parsed, on_lines);
+        syscall3(SYS_CLOSE, fd, 0, 0);
+        if (!ok) {
+            delete[] buf;
+            return nullptr;
+        }
+        buf[size] = '\0';
+        bytes = size;
+        return buf;
+    }
+
+    // Writes len bytes at the current offset of fd in large batched writes
+    static bool writeAll(long fd, const char* data, long len) {
+        if (len <= 0) return true;
+        if (!ring().ready()) return writeSync(fd, data, len);
+        long base = syscall3(SYS_LSEEK, fd, 0, SEEK_CUR);
+        if (base < 0) return writeSync(fd, data, len);
+        bool ok = transfer(fd, const_cast<char*>(data), len, base, OP_WRITE, nullptr);
+        syscall3(SYS_LSEEK, fd, base + len, SEEK_SET);
+        return ok;
+    }
+
+    // Writes data to tmp_path (default "<path>.tmp"), fsyncs it, renames it
+    // over path and fsyncs the directory. On failure path is left untouched.
+    static bool saveAtomic(const char* path, const char* data, long len, const char* tmp_path = nullptr) {
+        char derived[PATH_CHARS];
+        if (!tmp_path) {
+            if (!withSuffix(derived, path, ".tmp")) return false;
+            tmp_path = derived;
+        }
+        long fd = syscall3(SYS_OPEN, (long)tmp_path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (fd < 0) return false;
+        bool ok = writeAll(fd, data, len) && syscall3(SYS_FSYNC, fd, 0, 0) == 0;
+        syscall3(SYS_CLOSE, fd, 0, 0);
+        if (!ok || syscall3(SYS_RENAME, (long)tmp_path, (long)path, 0) < 0) {
+            syscall3(SYS_UNLINK, (long)tmp_path, 0, 0);
+            return false;
+        }
+        syncParentDir(path);
+        return true;
+    }
+
+    enum ChecksumState { CHECKSUM_NONE, CHECKSUM_OK, CHECKSUM_BAD };
+    static const int CHECKSUM_BYTES = 17;   // "# crc32 xxxxxxxx\n"
+
+    // Appends the trailer for buf[0, len); buf needs CHECKSUM_BYTES spare bytes
+    static long putChecksum(char* buf, long len) {
+        unsigned int crc = crc32(buf, len);
+        const char* tag = CHECKSUM_TAG;
+        while (*tag) buf[len++] = *tag++;
+        for (int shift = 28; shift >= 0; shift -= 4) buf[len++] = "0123456789abcdef"[(crc >> shift) & 0xF];
+        buf[len++] = '\n';
+        return len;
+    }
+
+    // Looks for a trailer on the last line; `body` is set to the length of
+    // the content it covers (all of buf when there is no trailer)
+    static ChecksumState checkChecksum(const char* buf, long len, long& body) {
+        body = len;
+        if (len < CHECKSUM_BYTES || buf[len - 1] != '\n') return CHECKSUM_NONE;
+        long start = len - CHECKSUM_BYTES;
+        if (start > 0 && buf[start - 1] != '\n') return CHECKSUM_NONE;
+        for (int k = 0; CHECKSUM_TAG[k]; ++k)
+            if (buf[start + k] != CHECKSUM_TAG[k]) return CHECKSUM_NONE;
+        unsigned int stored = 0;
+        for (long k = start + 8; k < len - 1; ++k) {
+            char c = buf[k];
+            int v = c >= '0' && c <= '9' ? c - '0' : c >= 'a' && c <= 'f' ? c - 'a' + 10 : -1;
+            if (v < 0) return CHECKSUM_NONE;
+            stored = (stored << 4) | static_cast<unsigned int>(v);
+        }
+        body = start;
+        return crc32(buf, start) == stored ? CHECKSUM_OK : CHECKSUM_BAD;
+    }
+
+    // CRC-32 (IEEE), slicing-by-8 so checksumming keeps up with the disk
+    static unsigned int crc32(const char* data, long len) {
+        const unsigned int (*t)[256] = crcTables();
+        const unsigned char* p = reinterpret_cast<const unsigned char*>(data);
+        unsigned int crc = 0xFFFFFFFFu;
+        for (; len >= 8; len -= 8, p += 8) {
+            unsigned int lo = crc ^ (p[0] | (p[1] << 8) | (p[2] << 16) | (static_cast<unsigned int>(p[3]) << 24));
+            crc = t[7][lo & 0xFF] ^ t[6][(lo >> 8) & 0xFF] ^ t[5][(lo >> 16) & 0xFF] ^ t[4][lo >> 24]
+                ^ t[3][p[4]] ^ t[2][p[5]] ^ t[1][p[6]] ^ t[0][p[7]];
+        }
+        while (len-- > 0) crc = t[0][(crc ^ *p++) & 0xFF] ^ (crc >> 8);
+        return ~crc;
+    }
+
+private:
+    static const int PATH_CHARS = 4096;
+    static constexpr const char* CHECKSUM_TAG = "# crc32 ";
+
+    static const long SYS_READ = 0;
+    static const long SYS_WRITE = 1;
+    static const long SYS_OPEN = 2;
+    static const long SYS_CLOSE = 3;
+    static const long SYS_LSEEK = 8;
+    static const long SYS_MMAP = 9;
+    static const long SYS_FSYNC = 74;
+    static const long SYS_RENAME = 82;
+    static const long SYS_UNLINK = 87;
+    static const long SYS_IO_URING_SETUP = 425;
+    static const long SYS_IO_URING_ENTER = 426;
+    static const long O_RDONLY = 0;
+    static const long O_WRONLY = 1;
+    static const long O_CREAT = 64;
+    static const long O_TRUNC = 512;
+    static const long O_DIRECTORY = 65536;
+    static const long SEEK_SET = 0;
+    static const long SEEK_CUR = 1;
+    static const long SEEK_END = 2;
+    static const unsigned char OP_READ = 22;    // IORING_OP_READ
+    static const unsigned char OP_WRITE = 23;   // IORING_OP_WRITE
+    static const unsigned int ENTER_GETEVENTS = 1;
+
+    struct SqRingOffsets { unsigned int head, tail, ring_mask, ring_entries, flags, dropped, array, resv1; unsigned long resv2; };
+    struct CqRingOffsets { unsigned int head, tail, ring_mask, ring_entries, overflow, cqes, flags, resv1; unsigned long resv2; };
+    struct Params {
+        unsigned int sq_entries, cq_entries, flags, sq_thread_cpu, sq_thread_idle, features, wq_fd, resv[3];
+        SqRingOffsets sq_off;
+        CqRingOffsets cq_off;
+    };
+    struct Sqe {
+        unsigned char opcode, flags;
+        unsigned short ioprio;
+        int fd;
+        unsigned long off, addr;
+        unsigned int len, rw_flags;
+        unsigned long user_data;
+        unsigned long pad[3];
+    };
+    struct Cqe {
+        unsigned long user_data;
+        int res;
+        unsigned int flags;
+    };
+    static_assert(sizeof(Params) == 120 && sizeof(Sqe) == 64 && sizeof(Cqe) == 16, "io_uring ABI");
+
+    // One lazily created ring shared by every load and save (single-threaded use)
+    struct Ring {
+        int state;   // 0 = untried, 1 = ready, -1 = unavailable
+        bool disabled;
+        long fd;
+        unsigned int *sq_tail, *sq_mask, *sq_array, *cq_head, *cq_tail, *cq_mask;
+        Sqe* sqes;
+        Cqe* cqes;
+
+        bool ready() {
+            if (disabled) return false;
+            if (state == 0) state = setup() ? 1 : -1;
+            return state == 1;
+        }
+
+        bool setup() {
+            Params p;
+            char* raw = reinterpret_cast<char*>(&p);
+            for (unsigned int i = 0; i < sizeof(p); ++i) raw[i] = 0;
+            fd = syscall3(SYS_IO_URING_SETUP, DEPTH, (long)&p, 0);
+            if (fd < 0) return false;
+            char* sq = map(p.sq_off.array + p.sq_entries * sizeof(unsigned int), 0);
+            char* cq = map(p.cq_off.cqes + p.cq_entries * sizeof(Cqe), 0x8000000L);    // IORING_OFF_CQ_RING
+            char* sqe = map(p.sq_entries * sizeof(Sqe), 0x10000000L);                  // IORING_OFF_SQES
+            if (!sq || !cq || !sqe) {
+                syscall3(SYS_CLOSE, fd, 0, 0);
+                return false;
+            }
+            sq_tail = reinterpret_cast<unsigned int*>(sq + p.sq_off.tail);
+            sq_mask = reinterpret_cast<unsigned int*>(sq + p.sq_off.ring_mask);
+            sq_array = reinterpret_cast<unsigned int*>(sq + p.sq_off.array);
+            cq_head = reinterpret_cast<unsigned int*>(cq + p.cq_off.head);
+            cq_tail = reinterpret_cast<unsigned int*>(cq + p.cq_off.tail);
+            cq_mask = reinterpret_cast<unsigned int*>(cq + p.cq_off.ring_mask);
+            sqes = reinterpret_cast<Sqe*>(sqe);
+            cqes = reinterpret_cast<Cqe*>(cq + p.cq_off.cqes);
+            return true;
+        }
+
+        char* map(unsigned long len, long offset) {
+            long addr = syscall6(SYS_MMAP, 0, len, 3, 0x8001, fd, offset); // RW, MAP_SHARED | MAP_POPULATE
+            return (addr < 0 && addr > -4096) ? nullptr : reinterpret_cast<char*>(addr);
+        }
+
+        void push(unsigned char op, long file, char* buf, unsigned int len, long off, unsigned long tag) {
+            unsigned int tail = *sq_tail;
+            unsigned int idx = tail & *sq_mask;
+            Sqe& e = sqes[idx];
+            char* raw = reinterpret_cast<char*>(&e);
+            for (unsigned int i = 0; i < sizeof(Sqe); ++i) raw[i] = 0;
+            e.opcode = op;
+            e.fd = static_cast<int>(file);
+            e.off = static_cast<unsigned long>(off);
+            e.addr = reinterpret_cast<unsigned long>(buf);
+            e.len = len;
+            e.user_data = tag;
+            sq_array[idx] = idx;
+            __atomic_store_n(sq_tail, tail + 1, __ATOMIC_RELEASE);
+        }
+
+        // Submits `count` queued entries and waits for at least one completion
+        bool enter(unsigned int count) {
+            return syscall6(SYS_IO_URING_ENTER, fd, count, 1, ENTER_GETEVENTS, 0, 0) >= 0;
+        }
+
+        bool pop(Cqe& out) {
+            unsigned int head = *cq_head;
+            if (head == __atomic_load_n(cq_tail, __ATOMIC_ACQUIRE)) return false;
+            out = cqes[head & *cq_mask];
+            __atomic_store_n(cq_head, head + 1, __ATOMIC_RELEASE);
+            return true;
+        }
+    };
+
+    static Ring& ring() {
+        static Ring r = {0, false, -1, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr};
+        return r;
+    }
+
+    // Hands on_lines everything from `parsed` up to the last newline before
+    // `available` (or up to `size` once the whole file is in)
+    template<typename Fn>
+    static void deliver(const char* buf, long available, long size, long& parsed, Fn& on_lines) {
+        long end = available;
+        if (end < size) {
+            while (end > parsed && buf[end - 1] != '\n') --end;
+        }
+        if (end > parsed) {
+            on_lines(buf + parsed, end - parsed);
+            parsed = end;
+        }
+    }
+
+    template<typename Fn>
+    static bool loadSync(long fd, char* buf, long size, long& parsed, Fn& on_lines) {
+        long have = 0;
+        while (have < size) {
+            long want = size - have < CHUNK ? size - have : CHUNK;
+            long n = syscall3(SYS_READ, fd, (long)(buf + have), want);
+            if (n <= 0) return false;
+            have += n;
+            deliver(buf, have, size, parsed, on_lines);
+        }
+        return true;
+    }
+
+    template<typename Fn>
+    static bool loadUring(long fd, char* buf, long size, long& parsed, Fn& on_lines) {
+        return transfer(fd, buf, size, 0, OP_READ, [&](long contiguous) {
+            deliver(buf, contiguous, size, parsed, on_lines);
+        });
+    }
+
+    // Moves `len` bytes between buf and the file at `base` in CHUNK-sized
+    // requests with up to DEPTH in flight. Short transfers are resubmitted.
+    // on_progress(bytes) reports the length of the completed prefix.
+    template<typename Progress>
+    static bool transfer(long fd, char* buf, long len, long base, unsigned char op, Progress on_progress) {
+        Ring& r = ring();
+        long chunks = (len + CHUNK - 1) / CHUNK;
+        long* done = new long[chunks];   // bytes finished per chunk
+        for (long i = 0; i < chunks; ++i) done[i] = 0;
+        long next = 0, inflight = 0, prefix = 0;
+        unsigned int queued = 0;
+        bool ok = true;
+        while (ok && prefix < chunks) {
+            while (next < chunks && inflight < DEPTH) {
+                long size = chunkSize(next, len);
+                r.push(op, fd, buf + next * CHUNK, static_cast<unsigned int>(size), base + next * CHUNK, next);
+                ++next;
+                ++inflight;
+                ++queued;
+            }
+            if (!r.enter(queued)) { ok = false; break; }
+            queued = 0;
+            Cqe cqe;
+            while (r.pop(cqe)) {
+                long k = static_cast<long>(cqe.user_data);
+                --inflight;
+                if (cqe.res <= 0) { ok = false; continue; }
+                done[k] += cqe.res;
+                long size = chunkSize(k, len);
+                if (done[k] < size) {   // short transfer: queue the rest of the chunk
+                    r.push(op, fd, buf + k * CHUNK + done[k], static_cast<unsigned int>(size - done[k]),
+                           base + k * CHUNK + done[k], k);
+                    ++inflight;
+                    ++queued;
+                }
+            }
+            long before = prefix;
+            while (prefix < chunks && done[prefix] == chunkSize(prefix, len)) ++prefix;
+            if (prefix > before) progress(on_progress, prefix == chunks ? len : prefix * CHUNK);
+        }
+        // Never leave requests pointing at memory the caller may free
+        while (inflight > 0) {
+            if (!r.enter(queued)) break;
+            queued = 0;
+            Cqe cqe;
+            while (r.pop(cqe)) --inflight;
+        }
+        delete[] done;
+        return ok;
+    }
+
+    static long chunkSize(long k, long len) {
+        long rest = len - k * CHUNK;
+        return rest < CHUNK ? rest : CHUNK;
+    }
+
+    template<typename Progress>
+    static void progress(Progress& fn, long bytes) { fn(bytes); }
+    static void progress(decltype(nullptr), long) {}
+
+    static const unsigned int (*crcTables())[256] {
+        static unsigned int t[8][256];
+        static bool built = false;
+        if (!built) {
+            for (unsigned int i = 0; i < 256; ++i) {
+                unsigned int c = i;
+                for (int k = 0; k < 8; ++k) c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+                t[0][i] = c;
+            }
+            for (unsigned int i = 0; i < 256; ++i)
+                for (int s = 1; s < 8; ++s) t[s][i] = t[0][t[s - 1][i] & 0xFF] ^ (t[s - 1][i] >> 8);
+            built = true;
+        }
+        return t;
+    }
+
+    static bool withSuffix(char* out, const char* path, const char* suffix) {
+        int n = 0;
+        for (; *path; ++path) {
+            if (n == PATH_CHARS - 1) return false;
+            out[n++] = *path;
+        }
+        for (; *suffix; ++suffix) {
+            if (n == PATH_CHARS - 1) return false;
+            out[n++] = *suffix;
+        }
+        out[n] = '\0';
+        return true;
+    }
+
+    // Makes the rename itself durable
+    static void syncParentDir(const char* path) {
+        char dir[PATH_CHARS];
+        int slash = -1;
+        int n = 0;
+        for (; path[n] && n < PATH_CHARS - 1; ++n) {
+            dir[n] = path[n];
+            if (path[n] == '/') slash = n;
+        }
+        if (slash < 0) {
+            dir[0] = '.';
+            dir[1] = '\0';
+        } else {
+            dir[slash == 0 ? 1 : slash] = '\0';
+        }
+        long fd = syscall3(SYS_OPEN, (long)dir, O_RDONLY | O_DIRECTORY, 0);
+        if (fd < 0) return;
+        syscall3(SYS_FSYNC, fd, 0, 0);
+        syscall3(SYS_CLOSE, fd, 0, 0);
+    }
+
+    static bool writeSync(long fd, const char* data, long len) {
+        long written = 0;
+        while (written < len) {
+            long want = len - written < CHUNK ? len - written : CHUNK;
+            long n = syscall3(SYS_WRITE, fd, (long)(data + written), want);
+            if (n <= 0) return false;
+            written += n;
+        }
+        return true;
+    }
+};
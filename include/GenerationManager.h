@@ -1,6 +1,13 @@
 #pragma once
 #include "UserDevice.h"
 #include "CellularCore.h"
+#include "NetworkConfig.h"
+#include "SpectrumPlan.h"
+#include "SlotHeap.h"
+#include "QosHeap.h"
+#include "CapacityModel.h"
+#include "Perf.h"
+#include "Trace.h"
 #include "basicIO.h"
 
 extern basicIO io;
@@ -10,250 +17,447 @@ private:
     char tech_name[32];
     char protocol[64];
     int messages_per_user;
+    int service_messages[NetworkConfig::MAX_SERVICES];
     int current_gen;
     static const int MAX_USERS = 10000;
-    static const int MAX_FREQUENCIES = 100;
-    UserDevice users[MAX_USERS];
+    UserDevice* users;        // grown on demand up to MAX_USERS (nothing is built up front)
+    int user_capacity;
     int user_count;
-    struct FrequencySlot {
-        int frequency_mhz;
-        int current_users;
-        int max_users;
-    } spectrum_slots[MAX_FREQUENCIES];
-    int slot_count;
+    SpectrumPlan spectrum_slots; // 🔥 sorted slots + band index (sized from profile)
     int total_spectrum_mhz;
     double channel_bandwidth_mhz;
     int users_per_channel;
     int antenna_factor;
     bool mimo_enabled;
+    double spatial_reuse;     // users per channel multiplier: antenna_factor until MU-MIMO grouping measures it
+    bool reuse_measured;
     CellularCore<long>* core; // 🔥 ADDED
+    SlotHeap placement;       // free-capacity index for auto placement
+    unsigned int trace_id;    // engine instance id in recorded traces
+    int service_users[NetworkConfig::MAX_SERVICES];      // running per-service totals
+    long service_message_load[NetworkConfig::MAX_SERVICES];
+    // 🔥 SINR capacity model (capacity shannon|cqi); arrays only exist when enabled
+    int capacity_kind;
+    float carrier_khz;
+    float sinr_mean_db;
+    float sinr_spread_db;
+    int service_kbps[NetworkConfig::MAX_SERVICES];
+    float* slot_load_khz;     // summed demand per slot
+    float* user_need_khz;     // per user, parallel to users[]
+    double total_load_khz;
+    unsigned long sinr_draws; // admission attempts so far: seeds the next SINR draw
+    static const int SINR_BLOCK = 1024;
+    float* sinr_eff;          // efficiencies of draws [eff_first, eff_first + eff_count)
+    unsigned long eff_first;
+    int eff_count;
+    // 🔥 Carrier aggregation: per-slot bitsets of the users holding each slot,
+    // so frequency queries are word scans and intersections. Bits are stable
+    // member ids, not user positions: removing a user clears its own bits and
+    // remaps the ids of the users that shift down, no bitset is compacted.
+    static const int MEMBER_WORDS = (MAX_USERS + 63) / 64;
+    static const int MAX_INDEXED_SLOTS = 1024;   // larger plans fall back to scanning users
+    int max_carriers;
+    unsigned long* slot_members;  // getSlotCount() x MEMBER_WORDS, or null
+    bool index_members;           // plan is small enough for bitsets (allocated on first admit)
+    int* user_member;             // member id of users[i] (parallel to users[])
+    int* member_user;             // user index holding each member id
+    int* free_members;            // released member ids, reused first
+    int free_count;
+    int member_high;              // member ids ever handed out: bitsets are scanned up to here
+    int aggregated_users;         // users holding 2+ carriers
 
 public:
     GenerationManager(int gen, CellularCore<long>* c)
-        : current_gen(gen), user_count(0), slot_count(0), core(c) {
+        : current_gen(gen), users(nullptr), user_capacity(0), user_count(0), core(c),
+          slot_load_khz(nullptr), user_need_khz(nullptr), sinr_eff(nullptr), slot_members(nullptr),
+          user_member(nullptr), member_user(nullptr), free_members(nullptr) {
+        placement_policy = PLACE_FIRST_FIT;
+        spill_on_full = false;
+        preemption = false;
         initializeFromGeneration(gen);
+        trace_id = Trace::attach(gen, core->getMaxCapacity());
+    }
+
+    ~GenerationManager() {
+        Trace::detach(trace_id, current_gen);
+        delete[] slot_load_khz;
+        delete[] user_need_khz;
+        delete[] sinr_eff;
+        delete[] slot_members;
+        delete[] user_member;
+        delete[] member_user;
+        delete[] free_members;
+        delete[] users;
     }
 
     void initializeFromGeneration(int gen) {
-        if (gen == 2) {
-            const char* t = "2G";
-            int i = 0; while (t[i]) { tech_name[i] = t[i]; ++i; } tech_name[i] = '\0';
-            const char* p = "TDMA (Time Division Multiple Access)";
-            i = 0; while (p[i] && i < 63) { protocol[i] = p[i]; ++i; } protocol[i] = '\0';
-            messages_per_user = 15;
-            total_spectrum_mhz = 1;
-            channel_bandwidth_mhz = 0.2;
-            users_per_channel = 16;
-            antenna_factor = 1;
-            mimo_enabled = false;
-            slot_count = 0;
-            for (int i = 0; i < 5; ++i) {
-                spectrum_slots[i].frequency_mhz = 1800 + (i * 200);
-                spectrum_slots[i].current_users = 0;
-                spectrum_slots[i].max_users = 16;
-                slot_count++;
-            }
-        } else if (gen == 3) {
-            const char* t = "3G";
-            int i = 0; while (t[i]) { tech_name[i] = t[i]; ++i; } tech_name[i] = '\0';
-            const char* p = "CDMA (Code Division Multiple Access)";
-            i = 0; while (p[i] && i < 63) { protocol[i] = p[i]; ++i; } protocol[i] = '\0';
-            messages_per_user = 10;
-            total_spectrum_mhz = 1;
-            channel_bandwidth_mhz = 0.2;
-            users_per_channel = 32;
-            antenna_factor = 1;
-            mimo_enabled = false;
-            slot_count = 0;
-            for (int i = 0; i < 5; ++i) {
-                spectrum_slots[i].frequency_mhz = 1800 + (i * 200);
-                spectrum_slots[i].current_users = 0;
-                spectrum_slots[i].max_users = 32;
-                slot_count++;
-            }
-        } else if (gen == 4) {
-            const char* t = "3.5G";
-            int i = 0; while (t[i]) { tech_name[i] = t[i]; ++i; } tech_name[i] = '\0';
-            const char* p = "HSPA (High-Speed Packet Access)";
-            i = 0; while (p[i] && i < 63) { protocol[i] = p[i]; ++i; } protocol[i] = '\0';
-            messages_per_user = 8;
-            total_spectrum_mhz = 1;
-            channel_bandwidth_mhz = 0.2;
-            users_per_channel = 64;
-            antenna_factor = 1;
-            mimo_enabled = false;
-            slot_count = 0;
-            for (int i = 0; i < 5; ++i) {
-                spectrum_slots[i].frequency_mhz = 1800 + (i * 200);
-                spectrum_slots[i].current_users = 0;
-                spectrum_slots[i].max_users = 64;
-                slot_count++;
-            }
-        } else if (gen == 5) {
-            const char* t = "4G";
-            int i = 0; while (t[i]) { tech_name[i] = t[i]; ++i; } tech_name[i] = '\0';
-            const char* p = "OFDM (Orthogonal Frequency Division Multiplexing)";
-            i = 0; while (p[i] && i < 63) { protocol[i] = p[i]; ++i; } protocol[i] = '\0';
-            messages_per_user = 10;
-            total_spectrum_mhz = 1;
-            channel_bandwidth_mhz = 0.01;
-            users_per_channel = 30;
-            antenna_factor = 4;
-            mimo_enabled = true;
-            slot_count = 0;
-            for (int i = 0; i < 10; ++i) {
-                spectrum_slots[i].frequency_mhz = 1800 + (i * 10);
-                spectrum_slots[i].current_users = 0;
-                spectrum_slots[i].max_users = 120;
-                slot_count++;
-            }
-        } else if (gen == 6) {
-            const char* t = "4G+";
-            int i = 0; while (t[i]) { tech_name[i] = t[i]; ++i; } tech_name[i] = '\0';
-            const char* p = "LTE-Advanced (Carrier Aggregation + OFDM)";
-            i = 0; while (p[i] && i < 63) { protocol[i] = p[i]; ++i; } protocol[i] = '\0';
-            messages_per_user = 8;
-            total_spectrum_mhz = 1;
-            channel_bandwidth_mhz = 0.01;
-            users_per_channel = 40;
-            antenna_factor = 4;
-            mimo_enabled = true;
-            slot_count = 0;
-            for (int i = 0; i < 10; ++i) {
-                spectrum_slots[i].frequency_mhz = 1800 + (i * 10);
-                spectrum_slots[i].current_users = 0;
-                spectrum_slots[i].max_users = 160;
-                slot_count++;
-            }
-        } else if (gen == 7) {
-            const char* t = "5G";
-            int i = 0; while (t[i]) { tech_name[i] = t[i]; ++i; } tech_name[i] = '\0';
-            const char* p = "OFDM + Massive MIMO";
-            i = 0; while (p[i] && i < 63) { protocol[i] = p[i]; ++i; } protocol[i] = '\0';
-            messages_per_user = 10;
-            total_spectrum_mhz = 11;
-            channel_bandwidth_mhz = 1.0;
-            users_per_channel = 30;
-            antenna_factor = 16;
-            mimo_enabled = true;
-            slot_count = 0;
-            for (int i = 0; i < 11; ++i) {
-                spectrum_slots[i].frequency_mhz = 1800 + (i * 1000);
-                spectrum_slots[i].current_users = 0;
-                spectrum_slots[i].max_users = 480;
-                slot_count++;
-            }
+        // 🔥 Profiles come from generations.cfg (or built-in defaults); flattened here once
+        const NetworkConfig& cfg = NetworkConfig::profile(gen);
+        int i = 0; while (cfg.name[i] && i < 31) { tech_name[i] = cfg.name[i]; ++i; } tech_name[i] = '\0';
+        i = 0; while (cfg.protocol[i] && i < 63) { protocol[i] = cfg.protocol[i]; ++i; } protocol[i] = '\0';
+        messages_per_user = cfg.messages_per_user;
+        for (int s = 0; s < NetworkConfig::MAX_SERVICES; ++s)
+            service_messages[s] = cfg.messagesFor(s);
+        total_spectrum_mhz = static_cast<int>(cfg.total_spectrum_mhz);
+        channel_bandwidth_mhz = cfg.channel_bandwidth_mhz;
+        users_per_channel = cfg.users_per_channel;
+        antenna_factor = cfg.antenna_factor;
+        mimo_enabled = cfg.mimo_enabled;
+        spatial_reuse = mimo_enabled ? antenna_factor : 1;
+        reuse_measured = false;
+        spectrum_slots.build(cfg);
+        for (int s = 0; s < NetworkConfig::MAX_SERVICES; ++s) {
+            service_users[s] = 0;
+            service_message_load[s] = 0;
+            service_kbps[s] = cfg.service_kbps[s];
         }
+        capacity_kind = cfg.capacity_kind;
+        carrier_khz = static_cast<float>(cfg.carrier_khz);
+        sinr_mean_db = static_cast<float>(cfg.sinr_mean_db);
+        sinr_spread_db = static_cast<float>(cfg.sinr_spread_db);
+        delete[] slot_load_khz;
+        delete[] user_need_khz;
+        delete[] sinr_eff;
+        slot_load_khz = nullptr;
+        user_need_khz = nullptr;
+        sinr_eff = nullptr;
+        if (capacity_kind != NetworkConfig::CAPACITY_FIXED) {
+            slot_load_khz = new float[spectrum_slots.getSlotCount()];
+            for (int i = 0; i < spectrum_slots.getSlotCount(); ++i) slot_load_khz[i] = 0;
+            user_need_khz = new float[MAX_USERS];
+            sinr_eff = new float[SINR_BLOCK];
+        }
+        total_load_khz = 0;
+        sinr_draws = 0;
+        eff_first = 0;
+        eff_count = 0;
+        max_carriers = cfg.max_carriers;
+        aggregated_users = 0;
+        delete[] slot_members;
+        slot_members = nullptr;
+        free_count = 0;
+        member_high = 0;
+        index_members = spectrum_slots.getSlotCount() <= MAX_INDEXED_SLOTS;
+        for (int s = 0; s < NetworkConfig::MAX_SERVICES; ++s) service_priority[s] = cfg.service_priority[s];
+        victims.reset(spectrum_slots.getSlotCount());
+        resetQosCounters();
+        rebuildPlacement();
+    }
+
+    GenerationManager(const GenerationManager&) = delete;
+    GenerationManager& operator=(const GenerationManager&) = delete;
+
+    // Drops every user and clears the core, keeping the user storage, so
+    // one engine can be reused for a fresh run (File Mode)
+    void reset() {
+        if (Trace::recording()) Trace::log(Trace::OP_RESET, trace_id, current_gen, 0, 0, 0);
+        user_count = 0;
+        core->reset();
+        initializeFromGeneration(current_gen);
     }
 
     bool isValidFrequency(int freq) const {
-        for (int i = 0; i < slot_count; ++i) {
-            if (spectrum_slots[i].frequency_mhz == freq) return true;
-        }
-        return false;
+        return spectrum_slots.findSlot(freq) >= 0;
     }
 
-    void addUser(int service_type, int freq) {
-        if (user_count >= MAX_USERS) return;
+    // Outcome of an admission attempt (tryAddUser never prints)
+    enum AdmitResult {
+        ADMIT_OK,
+        ADMIT_USER_LIMIT,
+        ADMIT_INVALID_FREQ,
+        ADMIT_SLOT_FULL,
+        ADMIT_CORE_FULL
+    };
 
-        // Validate frequency and slot
-        int slot_idx = -1;
-        for (int i = 0; i < slot_count; ++i) {
-            if (spectrum_slots[i].frequency_mhz == freq) {
-                if (spectrum_slots[i].current_users >= spectrum_slots[i].max_users) {
-                    io.errorstring("❌ ERROR: Frequency ");
-                    io.errorint(freq);
-                    io.errorstring(" MHz is full.\n");
-                    return;
-                }
-                slot_idx = i;
-                break;
-            }
-        }
-        if (slot_idx == -1) {
+    // How addUserAuto() chooses a slot
+    enum PlacementPolicy {
+        PLACE_FIRST_FIT,      // lowest frequency with space
+        PLACE_LEAST_LOADED,   // lowest users/max_users ratio
+        PLACE_LOAD_BALANCED   // lowest total message weight
+    };
+
+    // Per QoS class (service) admission outcomes
+    struct QosCounters {
+        long offered;       // attempts on a valid frequency
+        long admitted;
+        long blocked;       // slot, core or user table full
+        long preemptions;   // admissions that evicted a lower-priority user
+        long evicted;       // users of this class pushed out by a higher one
+    };
+
+    // carriers > 1 asks for carrier aggregation (clamped to the profile's limit)
+    AdmitResult tryAddUser(int service_type, int freq, int carriers = 1) {
+        AdmitResult result = attempt(service_type, freq, carriers);
+        countQos(service_type, result);
+        return result;
+    }
+
+private:
+    AdmitResult attempt(int service_type, int freq, int carriers) {
+        PERF_SCOPE(T_ADMIT);
+        AdmitResult result = admit(service_type, freq, carriers);
+        if (result == ADMIT_OK) PERF_COUNT(ADMITTED);
+        else if (result == ADMIT_SLOT_FULL) PERF_COUNT(REJECT_SLOT_FULL);
+        else if (result == ADMIT_CORE_FULL) PERF_COUNT(REJECT_CORE_FULL);
+        else if (result == ADMIT_INVALID_FREQ) PERF_COUNT(REJECT_INVALID_FREQ);
+        else PERF_COUNT(REJECT_USER_LIMIT);
+        if (Trace::recording())
+            Trace::log(Trace::OP_ADD, trace_id, current_gen, Trace::packService(service_type, carriers), result, freq);
+        return result;
+    }
+
+public:
+
+    void addUser(int service_type, int freq, int carriers = 1) {
+        reportAdmit(tryAddUser(service_type, freq, carriers), freq);
+    }
+
+    // Console message for an admission outcome at `freq`
+    void reportAdmit(AdmitResult result, int freq) const {
+        if (result == ADMIT_SLOT_FULL) {
+            io.errorstring("❌ ERROR: Frequency ");
+            io.errorint(freq);
+            io.errorstring(" MHz is full.\n");
+        } else if (result == ADMIT_INVALID_FREQ) {
             io.errorstring("❌ ERROR: Frequency ");
             io.errorint(freq);
             io.errorstring(" MHz is not valid for ");
             io.errorstring(getTechName());
             io.errorstring(" generation.\n");
-            return;
+        } else if (result == ADMIT_CORE_FULL) {
+            io.errorstring("❌ Rejected: Cellular core cannot accommodate additional messages due to overhead limit.\n");
+        } else if (result == ADMIT_OK) {
+            io.outputstring("✅ User added successfully.\n");
+        }
+    }
+
+    // 🔥 AUTO PLACEMENT: slot chosen by the active policy in O(log S).
+    // Returns the chosen frequency, or -1 if no slot has space.
+    int pickFrequency() const {
+        int slot_idx = placement.top();
+        return slot_idx < 0 ? -1 : spectrum_slots[slot_idx].frequency_mhz;
+    }
+
+    AdmitResult tryAddUserAuto(int service_type, int& freq_out, int carriers = 1) {
+        freq_out = pickFrequency();
+        if (freq_out < 0 && preemption && victims.bestSlot() >= 0)
+            freq_out = spectrum_slots[victims.bestSlot()].frequency_mhz;   // every slot full: try to preempt
+        if (freq_out < 0) {
+            countQos(service_type, ADMIT_SLOT_FULL);
+            return ADMIT_SLOT_FULL;
         }
+        AdmitResult result = attempt(service_type, freq_out, carriers);
+        if (result == ADMIT_SLOT_FULL && slot_load_khz) {
+            // Demand, not head count, turned it away: retry where there is most headroom
+            int best = leastDemandSlot();
+            if (best >= 0 && spectrum_slots[best].frequency_mhz != freq_out) {
+                freq_out = spectrum_slots[best].frequency_mhz;
+                result = attempt(service_type, freq_out, carriers);
+            }
+        }
+        countQos(service_type, result);
+        return result;
+    }
 
-        // Compute messages
-        int messages = messages_per_user;
-        if (current_gen == 2) {
-            if (service_type == 1) messages = 15;
-            else if (service_type == 2) messages = 2;
-            else if (service_type == 3) messages = 5;
-            else messages = 20;
-        } else if (current_gen == 5) {
-            if (service_type == 1) messages = 15;
-            else if (service_type == 2) messages = 2;
-            else if (service_type == 3) messages = 25;
-            else messages = 40;
-        } else if (current_gen == 6) {
-            if (service_type == 1) messages = 12;
-            else if (service_type == 2) messages = 2;
-            else if (service_type == 3) messages = 20;
-            else messages = 32;
-        } else if (current_gen == 7) {
-            if (service_type == 1) messages = 10;
-            else if (service_type == 2) messages = 2;
-            else if (service_type == 3) messages = 25;
-            else messages = 15;
+    int addUserAuto(int service_type, int carriers = 1) {
+        int freq = pickFrequency();
+        if (freq < 0 && (!preemption || victims.bestSlot() < 0)) {
+            io.errorstring("❌ ERROR: No ");
+            io.errorstring(getTechName());
+            io.errorstring(" frequency has space.\n");
+            return -1;
+        }
+        AdmitResult result = tryAddUserAuto(service_type, freq, carriers);
+        if (result != ADMIT_OK) {
+            reportAdmit(result, freq);
+            return -1;
         }
+        io.outputstring("✅ User added successfully on ");
+        io.outputint(freq);
+        io.outputstring(" MHz.\n");
+        return freq;
+    }
 
-        // 🔥 CORE OVERHEAD CHECK: reject if core cannot handle
-        if (!core->canRegister(messages)) {
-            io.errorstring("❌ Rejected: Cellular core cannot accommodate additional messages due to overhead limit.\n");
+    // frequency 0 means "auto"; a full typed/file frequency is re-placed when spill is on
+    void addUserPlaced(int service_type, int freq, int carriers = 1) {
+        if (wantsAutoPlacement(freq)) {
+            addUserAuto(service_type, carriers);
             return;
         }
+        addUser(service_type, freq, carriers);
+    }
 
-        // Register user
-        users[user_count].setID(user_count + 1);
-        users[user_count].setFrequency(freq);
-        users[user_count].setMessages(messages);
-        users[user_count].setServiceType(service_type);
-        user_count++;
-        spectrum_slots[slot_idx].current_users++;
+    // Quiet form of addUserPlaced(); freq_out receives the frequency actually tried
+    AdmitResult tryAddUserPlaced(int service_type, int freq, int& freq_out, int carriers = 1) {
+        if (wantsAutoPlacement(freq)) return tryAddUserAuto(service_type, freq_out, carriers);
+        freq_out = freq;
+        return tryAddUser(service_type, freq, carriers);
+    }
 
-        // 🔥 Register with core
-        core->registerUser(users[user_count - 1].getID(), messages);
+    bool wantsAutoPlacement(int freq) const {
+        if (freq == 0) return true;
+        if (!spill_on_full) return false;
+        int slot_idx = spectrum_slots.findSlot(freq);
+        return slot_idx >= 0 &&
+               spectrum_slots[slot_idx].current_users >= spectrum_slots[slot_idx].max_users;
+    }
 
-        io.outputstring("✅ User added successfully.\n");
+    void setPlacementPolicy(PlacementPolicy policy, bool spill) {
+        placement_policy = policy;
+        spill_on_full = spill;
+        rebuildPlacement();
     }
+    PlacementPolicy getPlacementPolicy() const { return placement_policy; }
+    bool getSpillOnFull() const { return spill_on_full; }
+
+    int messagesFor(int service_type) const { return service_messages[serviceIndex(service_type)]; }
+
+    // Services outside 1-4 are treated as Voice+Data, as in the profile table
+    static int serviceIndex(int service_type) { return NetworkConfig::serviceSlot(service_type); }
 
     void removeUser(int id) {
+        PERF_SCOPE(T_REMOVE);
         if (id <= 0 || id > user_count) return;
-        int idx = id - 1;
-        int freq = users[idx].getFrequency();
-        for (int i = 0; i < slot_count; ++i) {
-            if (spectrum_slots[i].frequency_mhz == freq) {
-                if (spectrum_slots[i].current_users > 0)
-                    spectrum_slots[i].current_users--;
-                break;
-            }
+        PERF_COUNT(REMOVED);
+        if (Trace::recording()) Trace::log(Trace::OP_REMOVE, trace_id, current_gen, 0, 0, id);
+        dropUser(id - 1);
+        // Note: core->current_load is not decremented (optional enhancement)
+    }
+
+    // 🔥 QoS PREEMPTION: when on, a full slot or core admits a higher-priority
+    // user by evicting the lowest-priority, most expensive one
+    void setPreemption(bool on) {
+        if (preemption == on) return;
+        preemption = on;
+        if (Trace::recording()) Trace::log(Trace::OP_PREEMPT, trace_id, current_gen, 0, 0, on ? 1 : 0);
+    }
+    bool getPreemption() const { return preemption; }
+    int getServicePriority(int service_type) const { return service_priority[serviceIndex(service_type)]; }
+    const QosCounters& getQos(int service_type) const { return qos[serviceIndex(service_type)]; }
+    void resetQosCounters() {
+        for (int s = 0; s < NetworkConfig::MAX_SERVICES; ++s) qos[s] = QosCounters{0, 0, 0, 0, 0};
+    }
+
+private:
+    // Removes users[idx] from every index; ids above it move down one
+    void dropUser(int idx) {
+        const UserDevice& u = users[idx];
+        // Release every component carrier; the message weight sits on the primary
+        int primary = spectrum_slots.findSlot(u.getFrequency());
+        float share = user_need_khz ? user_need_khz[idx] / u.getCarrierCount() : 0.0f;
+        int member = slot_members ? user_member[idx] : -1;
+        for (unsigned long m = u.getCarrierMask(); m; m &= m - 1) {
+            int slot_idx = u.getCarrierBase() + __builtin_ctzl(m);
+            if (member >= 0) members(slot_idx)[member >> 6] &= ~(1UL << (member & 63));
+            if (spectrum_slots[slot_idx].current_users <= 0) continue;
+            spectrum_slots.adjust(slot_idx, -1, slot_idx == primary ? -u.getMessages() : 0);
+            if (slot_load_khz) slot_load_khz[slot_idx] -= share;
+            placement.set(slot_idx, placementKey(slot_idx));
+            victims.remove(slot_idx, idx);
         }
+        victims.renumber(idx);
+        if (slot_load_khz) total_load_khz -= user_need_khz[idx];
+        if (u.getCarrierCount() > 1) --aggregated_users;
+        countService(u.getServiceType(), -1, -u.getMessages());
         for (int j = idx; j < user_count - 1; ++j)
             users[j] = users[j + 1];
+        // User ids are positions: the users above idx keep their member ids
+        // and only the id -> position map follows them down
+        if (member >= 0) {
+            free_members[free_count++] = member;
+            for (int j = idx; j < user_count - 1; ++j) {
+                user_member[j] = user_member[j + 1];
+                member_user[user_member[j]] = j;
+            }
+        }
+        if (user_need_khz) {
+            for (int j = idx; j < user_count - 1; ++j) user_need_khz[j] = user_need_khz[j + 1];
+        }
         user_count--;
-        // Note: core->current_load is not decremented (optional enhancement)
     }
 
+public:
+
+    int getGeneration() const { return current_gen; }
     const char* getTechName() const { return tech_name; }
     const char* getProtocol() const { return protocol; }
     int getTotalSpectrumMHz() const { return total_spectrum_mhz; }
     int getUserCount() const { return user_count; }
-    int getSlotCount() const { return slot_count; }
+    int getSlotCount() const { return spectrum_slots.getSlotCount(); }
+    int findSlot(int freq) const { return spectrum_slots.findSlot(freq); }
+    const SpectrumPlan& getSpectrum() const { return spectrum_slots; }
     int getSlotFrequency(int idx) const { return spectrum_slots[idx].frequency_mhz; }
     int getSlotUsers(int idx) const { return spectrum_slots[idx].current_users; }
     int getSlotMaxUsers(int idx) const { return spectrum_slots[idx].max_users; }
+    int getSlotUtilisation(int idx) const { return spectrum_slots[idx].utilisation_pct; }
+
+    // SINR capacity model state (all 0 with the fixed model)
+    int getCapacityKind() const { return capacity_kind; }
+    float getCarrierKhz() const { return carrier_khz; }
+    float getSinrMeanDb() const { return sinr_mean_db; }
+    float getSinrSpreadDb() const { return sinr_spread_db; }
+    int getSlotDemandPct(int idx) const {
+        return slot_load_khz ? static_cast<int>(slot_load_khz[idx] * 100 / carrier_khz) : 0;
+    }
+    int getDemandUtilisation() const {
+        double cap = static_cast<double>(carrier_khz) * spectrum_slots.getSlotCount();
+        return slot_load_khz && cap > 0 ? static_cast<int>(total_load_khz * 100 / cap) : 0;
+    }
+
+    // Carrier aggregation state
+    int getMaxCarriers() const { return max_carriers; }
+    int getAggregatedUserCount() const { return aggregated_users; }
+
+    // Users holding a carrier on `freq` (popcount of its member bitset)
+    int countUsersOnFrequency(int freq) const { return countUsersOnBoth(freq, freq); }
+
+    // Users aggregating both carriers: popcount of the bitset intersection
+    int countUsersOnBoth(int freq_a, int freq_b) const {
+        int a = spectrum_slots.findSlot(freq_a);
+        int b = spectrum_slots.findSlot(freq_b);
+        if (a < 0 || b < 0) return 0;
+        int count = 0;
+        if (slot_members) {
+            const unsigned long* x = members(a);
+            const unsigned long* y = members(b);
+            int words = (member_high + 63) >> 6;
+            for (int w = 0; w < words; ++w) count += __builtin_popcountl(x[w] & y[w]);
+            return count;
+        }
+        for (int i = 0; i < user_count; ++i) count += users[i].holdsSlot(a) && users[i].holdsSlot(b);
+        return count;
+    }
+
+    // 🔥 O(1) aggregates, maintained on every add/remove
+    long getTotalMessages() const { return spectrum_slots.getMessages(); }
+    long getSlotCapacity() const { return spectrum_slots.getCapacity(); }
+    int getFullSlotCount() const { return spectrum_slots.getFullSlots(); }
+    int getUtilisation() const {
+        long cap = spectrum_slots.getCapacity();
+        return cap > 0 ? static_cast<int>((spectrum_slots.getUsedUsers() * 100) / cap) : 0;
+    }
+    int getServiceUsers(int service_type) const { return service_users[serviceIndex(service_type)]; }
+    long getServiceMessages(int service_type) const { return service_message_load[serviceIndex(service_type)]; }
+    long getCoreLoad() const { return core->getCurrentLoad(); }
+    long getCoreCapacity() const { return core->getMaxCapacity(); }
     int getMaxUsersBySpectrum() const {
         int channels = static_cast<int>(total_spectrum_mhz / channel_bandwidth_mhz);
         int total = channels * users_per_channel;
-        if (mimo_enabled) total *= antenna_factor;
+        if (mimo_enabled) total = static_cast<int>(total * spatial_reuse);
         return total;
     }
+
+    // MIMO layers the profile allows per channel (antenna_factor, 1 without MIMO)
+    int getMaxLayers() const { return mimo_enabled ? antenna_factor : 1; }
+    double getSpatialReuse() const { return spatial_reuse; }
+    bool hasMeasuredReuse() const { return reuse_measured; }
+    // Replaces the antenna_factor multiplier with a reuse factor measured by MuMimoGrouper
+    void setSpatialReuse(double reuse) {
+        if (!mimo_enabled || reuse <= 0) return;
+        spatial_reuse = reuse;
+        reuse_measured = true;
+    }
+    int getMessagesPerUser() const { return messages_per_user; }
     int getCoresNeededForFull() const {
         long full_load = static_cast<long>(getMaxUsersBySpectrum()) * messages_per_user;
         long cap = core->getMaxCapacity();
@@ -261,8 +465,10 @@ public:
         return (full_load + cap - 1) / cap;
     }
 
+    const UserDevice& getUser(int idx) const { return users[idx]; }
+
     void getFirstChannelUsers(UserDevice out[], int& count) const {
-        int cap = users_per_channel * (mimo_enabled ? antenna_factor : 1);
+        int cap = static_cast<int>(users_per_channel * (mimo_enabled ? spatial_reuse : 1));
         count = (user_count < cap) ? user_count : cap;
         for (int i = 0; i < count; ++i) {
             out[i] = users[i];
@@ -270,12 +476,273 @@ public:
     }
 
     void getUsersOnFrequency(int freq, UserDevice out[], int& count) const {
+        PERF_SCOPE(T_QUERY);
+        PERF_COUNT(QUERIED);
         count = 0;
-        for (int i = 0; i < user_count && count < 100; ++i) {
-            if (users[i].getFrequency() == freq) {
-                out[count] = users[i];
-                ++count;
+        int slot_idx = spectrum_slots.findSlot(freq);
+        if (slot_idx >= 0 && slot_members) {
+            // Set bits of the slot's member bitset; the first 100 in user order
+            const unsigned long* bits = members(slot_idx);
+            int words = (member_high + 63) >> 6;
+            int first[100];
+            for (int w = 0; w < words; ++w) {
+                for (unsigned long m = bits[w]; m; m &= m - 1) {
+                    int user = member_user[(w << 6) + __builtin_ctzl(m)];
+                    if (count == 100 && user > first[99]) continue;
+                    int pos = count < 100 ? count++ : 99;
+                    while (pos > 0 && first[pos - 1] > user) {
+                        first[pos] = first[pos - 1];
+                        --pos;
+                    }
+                    first[pos] = user;
+                }
+            }
+            for (int i = 0; i < count; ++i) out[i] = users[first[i]];
+        } else if (slot_idx >= 0) {
+            for (int i = 0; i < user_count && count < 100; ++i) {
+                if (users[i].holdsSlot(slot_idx)) {
+                    out[count] = users[i];
+                    ++count;
+                }
+            }
+        }
+        if (Trace::recording()) Trace::log(Trace::OP_QUERY, trace_id, current_gen, 0, count, freq);
+    }
+
+private:
+    PlacementPolicy placement_policy;
+    bool spill_on_full;
+    // 🔥 QoS classes: priority per service, victims ordered per slot
+    int service_priority[NetworkConfig::MAX_SERVICES];
+    bool preemption;
+    QosHeap victims;
+    QosCounters qos[NetworkConfig::MAX_SERVICES];
+
+    void countQos(int service_type, AdmitResult result) {
+        if (result == ADMIT_INVALID_FREQ) return;
+        QosCounters& c = qos[serviceIndex(service_type)];
+        ++c.offered;
+        if (result == ADMIT_OK) ++c.admitted;
+        else ++c.blocked;
+    }
+
+    // Lowest-priority, most expensive user whose eviction makes room: on
+    // `full_slot` when that slot is full, else anywhere (core full). -1 if
+    // none ranks below the arriving service or evicting it would not help.
+    int pickVictim(int full_slot, int primary, int service_type, int messages, float share) const {
+        int slot = full_slot >= 0 ? full_slot : victims.bestSlot();
+        if (slot < 0) return -1;
+        int victim = victims.top(slot);
+        if (QosHeap::priorityOf(victims.topKey(slot)) >= service_priority[serviceIndex(service_type)]) return -1;
+        const UserDevice& u = users[victim];
+        if (!core->canRegister(messages - u.getMessages())) return -1;
+        if (slot_load_khz && full_slot >= 0) {
+            float freed = u.holdsSlot(primary) ? user_need_khz[victim] / u.getCarrierCount() : 0.0f;
+            if (slot_load_khz[primary] - freed + share > carrier_khz) return -1;
+        }
+        return victim;
+    }
+
+    void evict(int victim, int by_service) {
+        ++qos[serviceIndex(users[victim].getServiceType())].evicted;
+        ++qos[serviceIndex(by_service)].preemptions;
+        core->release(users[victim].getMessages());
+        dropUser(victim);
+    }
+
+    long placementKey(int slot_idx) const {
+        const SpectrumPlan::Slot& slot = spectrum_slots[slot_idx];
+        if (slot.current_users >= slot.max_users) return SlotHeap::FULL;
+        if (slot_load_khz) {   // capacity model: demand, not head count, fills a slot
+            if (slot_load_khz[slot_idx] >= carrier_khz) return SlotHeap::FULL;
+            if (placement_policy == PLACE_LEAST_LOADED)
+                return static_cast<long>(slot_load_khz[slot_idx] * (1 << 20) / carrier_khz);
+        }
+        if (placement_policy == PLACE_LEAST_LOADED)
+            return (static_cast<long>(slot.current_users) << 20) / slot.max_users;
+        if (placement_policy == PLACE_LOAD_BALANCED) return slot.messages;
+        return slot_idx; // first fit: slots are sorted by frequency
+    }
+
+    // Capacity model: open slot with the least summed demand (-1 if none)
+    int leastDemandSlot() const {
+        int best = -1;
+        for (int i = 0; i < spectrum_slots.getSlotCount(); ++i) {
+            if (spectrum_slots[i].current_users >= spectrum_slots[i].max_users) continue;
+            if (best < 0 || slot_load_khz[i] < slot_load_khz[best]) best = i;
+        }
+        return best;
+    }
+
+    unsigned long* members(int slot_idx) { return slot_members + static_cast<long>(slot_idx) * MEMBER_WORDS; }
+    const unsigned long* members(int slot_idx) const {
+        return slot_members + static_cast<long>(slot_idx) * MEMBER_WORDS;
+    }
+
+    // Secondary carriers for an aggregated user: the `want` least-loaded open
+    // slots in the primary's 64-slot window that can also take `share` kHz.
+    // Returns their bits relative to `base`, or 0 if fewer than `want` fit.
+    unsigned long pickSecondaries(int primary, int base, int want, float share) const {
+        int end = base + 64 < spectrum_slots.getSlotCount() ? base + 64 : spectrum_slots.getSlotCount();
+        unsigned long open = 0;
+        for (int s = base; s < end; ++s) {
+            if (s == primary || spectrum_slots[s].current_users >= spectrum_slots[s].max_users) continue;
+            if (slot_load_khz && slot_load_khz[s] + share > carrier_khz) continue;
+            open |= 1UL << (s - base);
+        }
+        if (__builtin_popcountl(open) < want) return 0;
+        unsigned long chosen = 0;
+        for (int k = 0; k < want; ++k) {
+            int best = -1;
+            long best_key = 0;
+            for (unsigned long m = open; m; m &= m - 1) {
+                int s = base + __builtin_ctzl(m);
+                const SpectrumPlan::Slot& slot = spectrum_slots[s];
+                long key = slot_load_khz ? static_cast<long>(slot_load_khz[s] * (1 << 20) / carrier_khz)
+                                         : (static_cast<long>(slot.current_users) << 20) / slot.max_users;
+                if (best < 0 || key < best_key) { best = s; best_key = key; }
+            }
+            chosen |= 1UL << (best - base);
+            open &= ~(1UL << (best - base));
+        }
+        return chosen;
+    }
+
+    void countService(int service_type, int users_delta, long messages_delta) {
+        int s = serviceIndex(service_type);
+        service_users[s] += users_delta;
+        service_message_load[s] += messages_delta;
+    }
+
+    AdmitResult admit(int service_type, int freq, int carriers) {
+        if (user_count >= MAX_USERS) return ADMIT_USER_LIMIT;
+        if (carriers > max_carriers) carriers = max_carriers;
+        if (carriers < 1) carriers = 1;
+
+        // Validate frequency and slot
+        int slot_idx = spectrum_slots.findSlot(freq);
+        if (slot_idx == -1) return ADMIT_INVALID_FREQ;
+        bool slot_full = spectrum_slots[slot_idx].current_users >= spectrum_slots[slot_idx].max_users;
+        if (slot_full && !preemption) return ADMIT_SLOT_FULL;
+
+        // 🔥 CAPACITY MODEL: this user's SINR decides how much carrier it needs
+        float need_khz = 0;
+        if (slot_load_khz) {
+            need_khz = CapacityModel::needAt(service_type, nextEfficiency(), service_kbps);
+            bool over = slot_load_khz[slot_idx] + need_khz / carriers > carrier_khz;
+            if (over && !preemption) return ADMIT_SLOT_FULL;
+            slot_full = slot_full || over;
+        }
+
+        // 🔥 CARRIER AGGREGATION: every carrier must have room before any is taken;
+        // the demand is spread evenly over the component carriers
+        float share = need_khz / carriers;
+        int base = slot_idx & ~63;
+        unsigned long mask = 1UL << (slot_idx - base);
+        if (carriers > 1) {
+            unsigned long secondaries = pickSecondaries(slot_idx, base, carriers - 1, share);
+            if (!secondaries) return ADMIT_SLOT_FULL;
+            mask |= secondaries;
+        }
+
+        // Compute messages (flat per-service table from the profile)
+        int messages = messagesFor(service_type);
+
+        // 🔥 CORE OVERHEAD CHECK: reject if core cannot handle
+        bool core_full = !core->canRegister(messages);
+        if (core_full && !preemption) return ADMIT_CORE_FULL;
+
+        // 🔥 QOS PREEMPTION: one lower-priority eviction must make room, or nothing changes
+        if (slot_full || core_full) {
+            int victim = pickVictim(slot_full ? slot_idx : -1, slot_idx, service_type, messages, share);
+            if (victim < 0) return slot_full ? ADMIT_SLOT_FULL : ADMIT_CORE_FULL;
+            evict(victim, service_type);
+        }
+
+        // Register user
+        reserveUser();
+        users[user_count].setID(user_count + 1);
+        users[user_count].setFrequency(freq);
+        users[user_count].setMessages(messages);
+        users[user_count].setServiceType(service_type);
+        users[user_count].setCarriers(base, mask);
+        int member = -1;
+        if (slot_members) {
+            member = free_count > 0 ? free_members[--free_count] : member_high++;
+            user_member[user_count] = member;
+            member_user[member] = user_count;
+        }
+        if (slot_load_khz) {
+            user_need_khz[user_count] = need_khz;
+            total_load_khz += need_khz;
+        }
+        for (unsigned long m = mask; m; m &= m - 1) {
+            int s = base + __builtin_ctzl(m);
+            spectrum_slots.adjust(s, 1, s == slot_idx ? messages : 0);
+            if (slot_load_khz) slot_load_khz[s] += share;
+            if (member >= 0) members(s)[member >> 6] |= 1UL << (member & 63);
+            placement.set(s, placementKey(s));
+            victims.add(s, user_count, QosHeap::key(service_priority[serviceIndex(service_type)], messages));
+        }
+        if (carriers > 1) ++aggregated_users;
+        user_count++;
+        countService(service_type, 1, messages);
+
+        // 🔥 Register with core
+        core->registerUser(users[user_count - 1].getID(), messages);
+        return ADMIT_OK;
+    }
+
+    // Spectral efficiency of the next SINR draw. Draws are prefetched
+    // SINR_BLOCK at a time through the SoA kernels; draw k is the same value
+    // whichever block computes it, so results do not depend on the blocking.
+    float nextEfficiency() {
+        unsigned long draw = sinr_draws++;
+        if (draw - eff_first >= static_cast<unsigned long>(eff_count)) {
+            float sinr[SINR_BLOCK];
+            CapacityModel::drawSinrSeries(sinr, SINR_BLOCK, (static_cast<unsigned long>(current_gen) << 40) + draw,
+                                          sinr_mean_db, sinr_spread_db);
+            CapacityModel::efficiency(sinr, sinr_eff, SINR_BLOCK, capacity_kind);
+            eff_first = draw;
+            eff_count = SINR_BLOCK;
+        }
+        return sinr_eff[draw - eff_first];
+    }
+
+    // Room for one more user; the membership bitsets come with the first one
+    void reserveUser() {
+        if (!slot_members && index_members) {
+            long words = static_cast<long>(spectrum_slots.getSlotCount()) * MEMBER_WORDS;
+            slot_members = new unsigned long[words];
+            for (long w = 0; w < words; ++w) slot_members[w] = 0;
+            if (!member_user) {
+                member_user = new int[MAX_USERS];
+                free_members = new int[MAX_USERS];
+                user_member = new int[user_capacity > 0 ? user_capacity : 1];
             }
+            free_count = 0;
+            member_high = 0;
+        }
+        if (user_count < user_capacity) return;
+        int cap = user_capacity > 0 ? user_capacity * 2 : 64;
+        if (cap > MAX_USERS) cap = MAX_USERS;
+        UserDevice* bigger = new UserDevice[cap];
+        for (int i = 0; i < user_count; ++i) bigger[i] = users[i];
+        delete[] users;
+        users = bigger;
+        if (member_user) {
+            int* ids = new int[cap];
+            for (int i = 0; i < user_count; ++i) ids[i] = user_member[i];
+            delete[] user_member;
+            user_member = ids;
         }
+        user_capacity = cap;
+    }
+
+    void rebuildPlacement() {
+        int n = spectrum_slots.getSlotCount();
+        placement.reset(n);
+        for (int i = 0; i < n; ++i) placement.load(i, placementKey(i));
+        placement.heapify();
     }
 };
@@ -0,0 +1,83 @@
+#pragma once
+
+// Parser for input.txt records: "<generation> <service> <frequency_mhz> [carriers]".
+// Comment (#) and blank lines are skipped, as are records for other
+// generations or with an invalid service digit. A frequency of 0 (or a
+// non-numeric word such as "auto") is passed through as 0. The optional
+// fourth field asks for carrier aggregation; it defaults to 1.
+class InputParser {
+public:
+    // Calls on_record(service, freq, carriers) for each record of generation `gen`;
+    // returns the number of records delivered.
+    template<typename Fn>
+    static long forEachRecord(const char* file_buf, long bytes, int gen, Fn on_record) {
+        long records = 0;
+        long pos = 0;
+        while (pos < bytes) {
+            // Skip comments/empty lines
+            while (pos < bytes && (file_buf[pos] == '#' || file_buf[pos] == '\n' || file_buf[pos] == '\r')) {
+                while (pos < bytes && file_buf[pos] != '\n') ++pos;
+                ++pos;
+            }
+            if (pos >= bytes) break;
+
+            if (file_buf[pos] < '2' || file_buf[pos] > '7') {
+                while (pos < bytes && file_buf[pos] != '\n') ++pos;
+                ++pos;
+                continue;
+            }
+
+            int file_gen = file_buf[pos] - '0';
+            ++pos;
+
+            if (file_gen != gen) {
+                // Skip line if not current generation
+                while (pos < bytes && file_buf[pos] != '\n') ++pos;
+                ++pos;
+                continue;
+            }
+
+            // Skip whitespace
+            while (pos < bytes && (file_buf[pos] == ' ' || file_buf[pos] == '\t')) ++pos;
+            if (pos >= bytes) break;
+
+            // Parse service
+            if (file_buf[pos] < '1' || file_buf[pos] > '4') {
+                while (pos < bytes && file_buf[pos] != '\n') ++pos;
+                ++pos;
+                continue;
+            }
+            int service = file_buf[pos] - '0';
+            ++pos;
+
+            // Skip whitespace
+            while (pos < bytes && (file_buf[pos] == ' ' || file_buf[pos] == '\t')) ++pos;
+            if (pos >= bytes) break;
+
+            // Parse frequency
+            int freq = 0;
+            while (pos < bytes && file_buf[pos] >= '0' && file_buf[pos] <= '9') {
+                freq = freq * 10 + (file_buf[pos] - '0');
+                ++pos;
+            }
+
+            // Optional component carrier count
+            while (pos < bytes && file_buf[pos] != ' ' && file_buf[pos] != '\t' && file_buf[pos] != '\n') ++pos;
+            while (pos < bytes && (file_buf[pos] == ' ' || file_buf[pos] == '\t')) ++pos;
+            int carriers = 0;
+            while (pos < bytes && file_buf[pos] >= '0' && file_buf[pos] <= '9' && carriers < 1000) {
+                carriers = carriers * 10 + (file_buf[pos] - '0');
+                ++pos;
+            }
+            if (carriers == 0) carriers = 1;
+
+            // Skip to next line
+            while (pos < bytes && file_buf[pos] != '\n') ++pos;
+            ++pos;
+
+            on_record(service, freq, carriers);
+            ++records;
+        }
+        return records;
+    }
+};
@@ -0,0 +1,128 @@
+#pragma once
+#include "GenerationManager.h"
+#include "OutBuffer.h"
+
+// 🔥 Machine-readable snapshot of spectrum and core state. Everything is
+// serialised straight into a caller-owned buffer (size it with maxBytes())
+// and written out with one syscall, so tooling can scrape often without
+// disturbing the simulation. All figures come from the running aggregates.
+//
+// JSON: {"generations": [{gen, name, users, utilisation_pct, full_slots,
+//        total_messages, services{...}, service_messages{...},
+//        core{load, capacity, cores_needed}, qos{voice{priority, offered,
+//        admitted, blocked, preemptions, evicted}, ...},
+//        slots[{freq_mhz, users, max_users}]}]}
+// CSV:  one row per slot with the generation-level figures repeated.
+class MetricsExport {
+public:
+    enum Format { FORMAT_JSON, FORMAT_CSV };
+
+    // Upper bound on the output size for these engines
+    static long maxBytes(const GenerationManager* const* managers, int n) {
+        long bytes = 256;
+        for (int i = 0; i < n; ++i) bytes += 2048 + static_cast<long>(managers[i]->getSlotCount()) * SLOT_BYTES;
+        return bytes;
+    }
+
+    // Returns false if the buffer was too small (output truncated)
+    static bool write(OutBuffer& out, const GenerationManager* const* managers, int n, Format format) {
+        if (format == FORMAT_CSV) writeCsv(out, managers, n);
+        else writeJson(out, managers, n);
+        return !out.overflowed();
+    }
+
+private:
+    // Worst-case bytes per slot: CSV row with every generation column
+    static const long SLOT_BYTES = 512;
+
+    static const char* serviceKey(int s) {
+        static const char* keys[NetworkConfig::MAX_SERVICES] = {"", "voice", "sms", "data", "voice_data"};
+        return keys[s];
+    }
+
+    static void putJsonString(OutBuffer& out, const char* text) {
+        out.put('"');
+        for (; *text; ++text) {
+            if (*text == '"' || *text == '\\') out.put('\\');
+            out.put(*text);
+        }
+        out.put('"');
+    }
+
+    static void writeJson(OutBuffer& out, const GenerationManager* const* managers, int n) {
+        out.put("{\"generations\": [");
+        for (int i = 0; i < n; ++i) {
+            const GenerationManager& m = *managers[i];
+            out.put(i > 0 ? ",\n  {" : "\n  {");
+            out.put("\"gen\": ").putInt(m.getGeneration());
+            out.put(", \"name\": ");
+            putJsonString(out, m.getTechName());
+            out.put(", \"users\": ").putInt(m.getUserCount());
+            out.put(", \"utilisation_pct\": ").putInt(m.getUtilisation());
+            out.put(", \"full_slots\": ").putInt(m.getFullSlotCount());
+            out.put(", \"total_messages\": ").putInt(m.getTotalMessages());
+            out.put(",\n   \"services\": {");
+            for (int s = 1; s < NetworkConfig::MAX_SERVICES; ++s) {
+                if (s > 1) out.put(", ");
+                out.put('"').put(serviceKey(s)).put("\": ").putInt(m.getServiceUsers(s));
+            }
+            out.put("}, \"service_messages\": {");
+            for (int s = 1; s < NetworkConfig::MAX_SERVICES; ++s) {
+                if (s > 1) out.put(", ");
+                out.put('"').put(serviceKey(s)).put("\": ").putInt(m.getServiceMessages(s));
+            }
+            out.put("},\n   \"core\": {\"load\": ").putInt(m.getCoreLoad())
+               .put(", \"capacity\": ").putInt(m.getCoreCapacity())
+               .put(", \"cores_needed\": ").putInt(m.getCoresNeededForFull()).put("},\n   \"qos\": {");
+            for (int s = 1; s < NetworkConfig::MAX_SERVICES; ++s) {
+                const GenerationManager::QosCounters& q = m.getQos(s);
+                if (s > 1) out.put(", ");
+                out.put('"').put(serviceKey(s)).put("\": {\"priority\": ").putInt(m.getServicePriority(s))
+                   .put(", \"offered\": ").putInt(q.offered).put(", \"admitted\": ").putInt(q.admitted)
+                   .put(", \"blocked\": ").putInt(q.blocked).put(", \"preemptions\": ").putInt(q.preemptions)
+                   .put(", \"evicted\": ").putInt(q.evicted).put('}');
+            }
+            out.put("},\n   \"slots\": [");
+            for (int k = 0; k < m.getSlotCount(); ++k) {
+                if (k > 0) out.put(", ");
+                out.put("{\"freq_mhz\": ").putInt(m.getSlotFrequency(k))
+                   .put(", \"users\": ").putInt(m.getSlotUsers(k))
+                   .put(", \"max_users\": ").putInt(m.getSlotMaxUsers(k)).put('}');
+            }
+            out.put("]}");
+        }
+        out.put("\n]}\n");
+    }
+
+    static void writeCsv(OutBuffer& out, const GenerationManager* const* managers, int n) {
+        out.put("gen,name,freq_mhz,slot_users,slot_max_users,users,utilisation_pct,full_slots,total_messages");
+        for (int s = 1; s < NetworkConfig::MAX_SERVICES; ++s) out.put(',').put(serviceKey(s));
+        for (int s = 1; s < NetworkConfig::MAX_SERVICES; ++s) out.put(',').put(serviceKey(s)).put("_messages");
+        out.put(",core_load,core_capacity,cores_needed");
+        for (int s = 1; s < NetworkConfig::MAX_SERVICES; ++s) out.put(',').put(serviceKey(s)).put("_blocked");
+        for (int s = 1; s < NetworkConfig::MAX_SERVICES; ++s) out.put(',').put(serviceKey(s)).put("_evicted");
+        out.put('\n');
+        for (int i = 0; i < n; ++i) {
+            const GenerationManager& m = *managers[i];
+            // Generation-level columns are the same on every row; render them once
+            char tail_storage[768];
+            OutBuffer tail(tail_storage, sizeof(tail_storage));
+            tail.put(',').putInt(m.getUserCount()).put(',').putInt(m.getUtilisation())
+                .put(',').putInt(m.getFullSlotCount()).put(',').putInt(m.getTotalMessages());
+            for (int s = 1; s < NetworkConfig::MAX_SERVICES; ++s) tail.put(',').putInt(m.getServiceUsers(s));
+            for (int s = 1; s < NetworkConfig::MAX_SERVICES; ++s) tail.put(',').putInt(m.getServiceMessages(s));
+            tail.put(',').putInt(m.getCoreLoad()).put(',').putInt(m.getCoreCapacity())
+                .put(',').putInt(m.getCoresNeededForFull());
+            for (int s = 1; s < NetworkConfig::MAX_SERVICES; ++s) tail.put(',').putInt(m.getQos(s).blocked);
+            for (int s = 1; s < NetworkConfig::MAX_SERVICES; ++s) tail.put(',').putInt(m.getQos(s).evicted);
+            tail.put('\n');
+
+            for (int k = 0; k < m.getSlotCount(); ++k) {
+                out.putInt(m.getGeneration()).put(',').put(m.getTechName())
+                   .put(',').putInt(m.getSlotFrequency(k)).put(',').putInt(m.getSlotUsers(k))
+                   .put(',').putInt(m.getSlotMaxUsers(k));
+                for (long b = 0; b < tail.size(); ++b) out.put(tail.data()[b]);
+            }
+        }
+    }
+};
@@ -0,0 +1,284 @@
+#pragma once
+#include "GenerationManager.h"
+
+// 🔥 Multi-user MIMO grouping for the massive-MIMO generations. Every user of
+// a slot gets a channel vector to the base station array, and the users are
+// partitioned into groups that can share one time/frequency resource as
+// separate spatial layers. Groups are built by semi-orthogonal user selection
+// (SUS): repeatedly take the user with the strongest channel component
+// orthogonal to the layers already chosen, then drop candidates that are too
+// correlated with it. Users that do not fit a group wait for a later one.
+//
+// Under zero-forcing precoding a user keeps the fraction |g|^2 / |h|^2 of its
+// channel gain, where g is its component orthogonal to the earlier layers. The
+// sum of those fractions is the group's effective layer count, and the mean
+// over all groups is the slot's spatial reuse factor. That factor replaces
+// the profile's fixed antenna_factor.
+//
+// Channels are stored as split real/imaginary arrays, one antenna-padded row
+// per user. The correlation kernel (q^H h against every candidate) runs four
+// antennas per SSE operation through GCC vector extensions.
+class MuMimoGrouper {
+public:
+    static const int MAX_ANTENNAS = 64;
+    static constexpr float DEFAULT_EPSILON = 0.4f;   // max |q^H h| / |h| to share a group
+
+    // Array size for a layer count: 4 antennas per layer (16 layers -> 64T64R)
+    static int antennasFor(int layers) {
+        int m = layers * 4;
+        return m > MAX_ANTENNAS ? MAX_ANTENNAS : (m < 4 ? 4 : m);
+    }
+
+    MuMimoGrouper(int max_layers, int capacity)
+        : layers(max_layers < 1 ? 1 : max_layers), antennas(antennasFor(layers)),
+          cap(capacity < 1 ? 1 : capacity), n(0), groups(0), effective_layers(0) {
+        h_re = new float[static_cast<long>(cap) * antennas];
+        h_im = new float[static_cast<long>(cap) * antennas];
+        q_re = new float[static_cast<long>(layers) * antennas];
+        q_im = new float[static_cast<long>(layers) * antennas];
+        norm2 = new float[cap];
+        resid = new float[cap];
+        group_of = new int[cap];
+        order = new int[cap];
+        cand = new int[cap];
+        group_size = new int[cap];
+        group_eff = new float[cap];
+    }
+
+    ~MuMimoGrouper() {
+        delete[] h_re;
+        delete[] h_im;
+        delete[] q_re;
+        delete[] q_im;
+        delete[] norm2;
+        delete[] resid;
+        delete[] group_of;
+        delete[] order;
+        delete[] cand;
+        delete[] group_size;
+        delete[] group_eff;
+    }
+
+    MuMimoGrouper(const MuMimoGrouper&) = delete;
+    MuMimoGrouper& operator=(const MuMimoGrouper&) = delete;
+
+    void clear() {
+        n = 0;
+        groups = 0;
+        effective_layers = 0;
+    }
+
+    // Adds a user with a clustered line-of-sight channel: PATHS rays within
+    // +-5 degrees of a direction in the array's +-60 degree sector, each with
+    // a random phase. Returns its index or -1 when full.
+    int addUser(unsigned long seed) {
+        if (n >= cap) return -1;
+        float* re = row(h_re, n);
+        float* im = row(h_im, n);
+        for (int m = 0; m < antennas; ++m) { re[m] = 0; im[m] = 0; }
+        seed = mix(seed);
+        float u = 0.866f * (2.0f * unit(seed) - 1.0f);   // sin(azimuth)
+        for (int p = 0; p < PATHS; ++p) {
+            seed = mix(seed + 0x9E3779B97F4A7C15UL);
+            float up = u + 0.087f * (2.0f * unit(seed) - 1.0f);
+            float phase = 6.2831853f * unit(seed >> 20);
+            // Half-wavelength ULA: antenna m sees phase + pi * m * sin(angle)
+            float step_re, step_im, cur_re, cur_im;
+            sincos(3.1415927f * up, step_im, step_re);
+            sincos(phase, cur_im, cur_re);
+            for (int m = 0; m < antennas; ++m) {
+                re[m] += cur_re;
+                im[m] += cur_im;
+                float next_re = cur_re * step_re - cur_im * step_im;
+                cur_im = cur_re * step_im + cur_im * step_re;
+                cur_re = next_re;
+            }
+        }
+        float e = 0;
+        for (int m = 0; m < antennas; ++m) e += re[m] * re[m] + im[m] * im[m];
+        norm2[n] = e > 1e-12f ? e : 1e-12f;
+        group_of[n] = -1;
+        return n++;
+    }
+
+    // Loads every user holding the slot (aggregated users included). Channels
+    // are a deterministic per-user draw, so repeated runs group identically.
+    int loadSlot(const GenerationManager& manager, int slot_idx) {
+        clear();
+        unsigned long salt = static_cast<unsigned long>(manager.getSlotFrequency(slot_idx)) << 32;
+        for (int i = 0; i < manager.getUserCount(); ++i) {
+            if (!manager.getUser(i).holdsSlot(slot_idx)) continue;
+            if (addUser(salt + static_cast<unsigned long>(i + 1)) < 0) break;
+        }
+        return n;
+    }
+
+    // Partitions the loaded users into groups of at most `layers` users;
+    // returns the number of groups
+    int group(float epsilon = DEFAULT_EPSILON) {
+        groups = 0;
+        effective_layers = 0;
+        float eps2 = epsilon * epsilon;
+        int remaining = n;   // order[0, remaining) = users not yet grouped
+        for (int k = 0; k < n; ++k) { order[k] = k; group_of[k] = -1; }
+        while (remaining > 0) {
+            int count = remaining;
+            for (int k = 0; k < remaining; ++k) {
+                cand[k] = order[k];
+                resid[order[k]] = norm2[order[k]];
+            }
+            int size = 0;
+            float eff = 0;
+            while (size < layers && count > 0) {
+                int best = 0;
+                for (int k = 1; k < count; ++k)
+                    if (resid[cand[k]] > resid[cand[best]]) best = k;
+                int user = cand[best];
+                cand[best] = cand[--count];
+                eff += resid[user] / norm2[user];
+                group_of[user] = groups;
+                basis(size, user);
+                count = project(size, count, eps2);
+                ++size;
+            }
+            group_size[groups] = size;
+            group_eff[groups] = eff;
+            effective_layers += eff;
+            ++groups;
+            int kept = 0;
+            for (int k = 0; k < remaining; ++k)
+                if (group_of[order[k]] < 0) order[kept++] = order[k];
+            remaining = kept;
+        }
+        return groups;
+    }
+
+    int getUserCount() const { return n; }
+    int getLayers() const { return layers; }
+    int getAntennas() const { return antennas; }
+    int getGroupCount() const { return groups; }
+    int getGroupSize(int g) const { return group_size[g]; }
+    float getGroupEffectiveLayers(int g) const { return group_eff[g]; }
+    int getGroupOf(int user) const { return group_of[user]; }
+    double getMeanGroupSize() const { return groups > 0 ? static_cast<double>(n) / groups : 0.0; }
+
+    // Mean effective layers per group: users one resource carries at full gain
+    double getSpatialReuse() const { return groups > 0 ? effective_layers / groups : 0.0; }
+
+private:
+    static const int PATHS = 3;
+    typedef float v4f __attribute__((vector_size(16)));
+
+    int layers;
+    int antennas;            // row length, a multiple of 4
+    int cap;
+    int n;
+    float* h_re;             // channel rows, cap x antennas
+    float* h_im;
+    float* q_re;             // orthonormal basis of the group being built, layers x antennas
+    float* q_im;
+    float* norm2;            // |h|^2 per user
+    float* resid;            // |g|^2: channel energy orthogonal to the current basis
+    int* group_of;
+    int* order;              // users not grouped yet
+    int* cand;               // candidates for the group being built
+    int* group_size;
+    float* group_eff;
+    int groups;
+    double effective_layers;
+
+    float* row(float* base, int i) const { return base + static_cast<long>(i) * antennas; }
+
+    static v4f load(const float* p) { v4f v; __builtin_memcpy(&v, p, sizeof(v)); return v; }
+    static void store(float* p, v4f v) { __builtin_memcpy(p, &v, sizeof(v)); }
+    static float sum(v4f v) { return (v[0] + v[1]) + (v[2] + v[3]); }
+
+    // q^H h over the array, four antennas per step
+    void dot(const float* qr, const float* qi, const float* hr, const float* hi, float& re, float& im) const {
+        v4f acc_re = {0, 0, 0, 0};
+        v4f acc_im = {0, 0, 0, 0};
+        for (int m = 0; m < antennas; m += 4) {
+            v4f a = load(qr + m), b = load(qi + m), x = load(hr + m), y = load(hi + m);
+            acc_re += a * x + b * y;
+            acc_im += a * y - b * x;
+        }
+        re = sum(acc_re);
+        im = sum(acc_im);
+    }
+
+    // Layer j of the basis: the user's channel minus its projection on layers 0..j-1, normalised
+    void basis(int j, int user) {
+        float* qr = row(q_re, j);
+        float* qi = row(q_im, j);
+        const float* hr = row(h_re, user);
+        const float* hi = row(h_im, user);
+        for (int m = 0; m < antennas; m += 4) { store(qr + m, load(hr + m)); store(qi + m, load(hi + m)); }
+        for (int i = 0; i < j; ++i) {
+            const float* pr = row(q_re, i);
+            const float* pi = row(q_im, i);
+            float cr, ci;
+            dot(pr, pi, hr, hi, cr, ci);
+            v4f vr = {cr, cr, cr, cr}, vi = {ci, ci, ci, ci};
+            for (int m = 0; m < antennas; m += 4) {
+                v4f a = load(pr + m), b = load(pi + m);
+                store(qr + m, load(qr + m) - (a * vr - b * vi));
+                store(qi + m, load(qi + m) - (a * vi + b * vr));
+            }
+        }
+        v4f e = {0, 0, 0, 0};
+        for (int m = 0; m < antennas; m += 4) {
+            v4f a = load(qr + m), b = load(qi + m);
+            e += a * a + b * b;
+        }
+        float energy = sum(e);
+        float scale = energy > 1e-20f ? 1.0f / __builtin_sqrtf(energy) : 0.0f;
+        v4f s = {scale, scale, scale, scale};
+        for (int m = 0; m < antennas; m += 4) {
+            store(qr + m, load(qr + m) * s);
+            store(qi + m, load(qi + m) * s);
+        }
+    }
+
+    // Removes layer j's direction from every candidate and drops the ones
+    // correlated with it beyond epsilon; returns the new candidate count
+    int project(int j, int count, float eps2) {
+        const float* qr = row(q_re, j);
+        const float* qi = row(q_im, j);
+        for (int k = 0; k < count;) {
+            int u = cand[k];
+            float cr, ci;
+            dot(qr, qi, row(h_re, u), row(h_im, u), cr, ci);
+            float p = cr * cr + ci * ci;
+            resid[u] -= p;
+            if (p > eps2 * norm2[u] || resid[u] <= 1e-4f * norm2[u]) cand[k] = cand[--count];
+            else ++k;
+        }
+        return count;
+    }
+
+    static unsigned long mix(unsigned long x) {
+        x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9UL;
+        x = (x ^ (x >> 27)) * 0x94D049BB133111EBUL;
+        return x ^ (x >> 31);
+    }
+
+    static float unit(unsigned long x) { return static_cast<float>(x >> 40) / 16777216.0f; }
+
+    // sin/cos of any angle: reduce to [-pi, pi], fold to [-pi/2, pi/2], degree-9 Taylor
+    static void sincos(float x, float& s, float& c) {
+        const float pi = 3.14159265f;
+        x -= 2 * pi * static_cast<float>(static_cast<int>(x / (2 * pi) + (x < 0 ? -0.5f : 0.5f)));
+        s = sinFolded(x);
+        float y = x + pi / 2;
+        if (y > pi) y -= 2 * pi;
+        c = sinFolded(y);
+    }
+
+    static float sinFolded(float x) {   // x in [-pi, pi]
+        const float pi = 3.14159265f;
+        if (x > pi / 2) x = pi - x;
+        else if (x < -pi / 2) x = -pi - x;
+        float x2 = x * x;
+        return x * (1 + x2 * (-1.0f / 6 + x2 * (1.0f / 120 + x2 * (-1.0f / 5040 + x2 * (1.0f / 362880)))));
+    }
+};
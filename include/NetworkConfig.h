@@ -1,97 +1,384 @@
 #pragma once
+#include "exceptions.h"
+#include "basicIO.h"
 
 class NetworkConfig {
 public:
+    static const int MIN_GEN = 2;
+    static const int MAX_GEN = 7;
+    static const int MAX_SERVICES = 5;   // index 1..4 (0 unused)
+    static const int MAX_BANDS = 64;
+    static const int MAX_SLOTS = 65536;  // carriers per generation across all bands
+    static const int MAX_PRIORITY = 15;  // QoS classes 0 (lowest) .. 15
+    static const int MAX_CARRIERS = 16;  // component carriers per user, from one 64-slot window
+
+    // How slot capacity is decided (see CapacityModel.h)
+    enum CapacityKind {
+        CAPACITY_FIXED,     // band max_users per slot
+        CAPACITY_SHANNON,   // SINR -> attenuated Shannon efficiency -> summed demand
+        CAPACITY_CQI        // SINR -> LTE CQI table efficiency -> summed demand
+    };
+
+    // A band is a uniform run of carriers: start, start+step, ... (count carriers)
+    struct Band {
+        int start_mhz;
+        int step_mhz;
+        int count;
+        int max_users;
+    };
+
+    int generation;
     char name[16];
+    char protocol[64];
     double total_spectrum_mhz;
     double channel_bandwidth_mhz;
     int users_per_channel;
     int messages_per_user;
     int antenna_factor;
     bool mimo_enabled;
+    int fallback_gen;                   // next generation to try when full (0 = none)
+    int service_messages[MAX_SERVICES]; // 1=Voice, 2=SMS, 3=Data, 4=Voice+Data
+    int capacity_kind;                  // CapacityKind
+    double sinr_mean_db;                // user SINR distribution (Gaussian)
+    double sinr_spread_db;
+    int carrier_khz;                    // usable bandwidth per slot
+    int service_kbps[MAX_SERVICES];     // demand per service, kbit/s
+    int max_carriers;                   // component carriers a user may aggregate (1 = off)
+    int service_priority[MAX_SERVICES]; // QoS admission priority by service (higher preempts lower)
+    Band bands[MAX_BANDS];
+    int band_count;
 
     NetworkConfig() {
+        generation = 0;
         name[0] = '\0';
+        protocol[0] = '\0';
         total_spectrum_mhz = 1.0;
         channel_bandwidth_mhz = 0.2;
         users_per_channel = 16;
         messages_per_user = 15;
         antenna_factor = 1;
         mimo_enabled = false;
+        fallback_gen = 0;
+        for (int s = 0; s < MAX_SERVICES; ++s) service_messages[s] = messages_per_user;
+        capacity_kind = CAPACITY_FIXED;
+        sinr_mean_db = 10.0;
+        sinr_spread_db = 6.0;
+        carrier_khz = 200;
+        setServiceKbps(12, 1, 40);
+        max_carriers = 1;
+        setServicePriority(3, 1, 0, 2);
+        band_count = 0;
     }
 
     static NetworkConfig for2G() {
         NetworkConfig c;
+        c.generation = 2;
         c.setName("2G");
+        c.setProtocol("TDMA (Time Division Multiple Access)");
         c.total_spectrum_mhz = 1.0;
         c.channel_bandwidth_mhz = 0.2;   // 200 kHz
         c.users_per_channel = 16;
         c.messages_per_user = 15;
         c.antenna_factor = 1;
         c.mimo_enabled = false;
+        c.setServiceMessages(15, 2, 5, 20);
+        c.carrier_khz = 200;
+        c.setServiceKbps(12, 1, 40);
+        c.addBand(1800, 200, 5, 16);
         return c;
     }
 
     static NetworkConfig for3G() {
         NetworkConfig c;
+        c.generation = 3;
         c.setName("3G");
+        c.setProtocol("CDMA (Code Division Multiple Access)");
         c.total_spectrum_mhz = 1.0;
         c.channel_bandwidth_mhz = 0.2;
         c.users_per_channel = 32;
         c.messages_per_user = 10;
         c.antenna_factor = 1;
         c.mimo_enabled = false;
+        c.fallback_gen = 2;
+        c.setServiceMessages(10, 10, 10, 10);
+        c.carrier_khz = 5000;
+        c.setServiceKbps(12, 1, 128);
+        c.addBand(1800, 200, 5, 32);
         return c;
     }
 
     static NetworkConfig for35G() {
         NetworkConfig c;
+        c.generation = 4;
         c.setName("3.5G");
+        c.setProtocol("HSPA (High-Speed Packet Access)");
         c.total_spectrum_mhz = 1.0;
         c.channel_bandwidth_mhz = 0.2;
         c.users_per_channel = 64;
         c.messages_per_user = 8;
         c.antenna_factor = 1;
         c.mimo_enabled = false;
+        c.fallback_gen = 3;
+        c.setServiceMessages(8, 8, 8, 8);
+        c.carrier_khz = 5000;
+        c.setServiceKbps(12, 1, 384);
+        c.addBand(1800, 200, 5, 64);
         return c;
     }
 
     static NetworkConfig for4G() {
         NetworkConfig c;
+        c.generation = 5;
         c.setName("4G");
+        c.setProtocol("OFDM (Orthogonal Frequency Division Multiplexing)");
         c.total_spectrum_mhz = 1.0;
         c.channel_bandwidth_mhz = 0.01;  // 10 kHz
         c.users_per_channel = 30;
         c.messages_per_user = 10;
         c.antenna_factor = 4;
         c.mimo_enabled = true;
+        c.fallback_gen = 4;
+        c.setServiceMessages(15, 2, 25, 40);
+        c.carrier_khz = 18000;           // 100 RBs x 180 kHz
+        c.setServiceKbps(12, 1, 1000);
+        c.addBand(1800, 10, 10, 120);
         return c;
     }
 
     static NetworkConfig for4GPlus() {
         NetworkConfig c;
+        c.generation = 6;
         c.setName("4G+");
+        c.setProtocol("LTE-Advanced (Carrier Aggregation + OFDM)");
         c.total_spectrum_mhz = 1.0;
         c.channel_bandwidth_mhz = 0.01;
         c.users_per_channel = 40;
         c.messages_per_user = 8;
         c.antenna_factor = 4;
         c.mimo_enabled = true;
+        c.fallback_gen = 5;
+        c.setServiceMessages(12, 2, 20, 32);
+        c.carrier_khz = 18000;
+        c.setServiceKbps(12, 1, 2000);
+        c.max_carriers = 5;              // LTE-A Rel-10: up to 5 component carriers
+        c.addBand(1800, 10, 10, 160);
         return c;
     }
 
     static NetworkConfig for5G() {
         NetworkConfig c;
+        c.generation = 7;
         c.setName("5G");
+        c.setProtocol("OFDM + Massive MIMO");
         c.total_spectrum_mhz = 11.0;     // 1 + 10 MHz
         c.channel_bandwidth_mhz = 1.0;
         c.users_per_channel = 30;
         c.messages_per_user = 10;
         c.antenna_factor = 16;
         c.mimo_enabled = true;
+        c.fallback_gen = 6;
+        c.setServiceMessages(10, 2, 25, 15);
+        c.carrier_khz = 49140;           // 273 RBs x 180 kHz
+        c.setServiceKbps(12, 1, 4000);
+        c.addBand(1800, 1000, 11, 480);
         return c;
     }
 
+    static NetworkConfig forGeneration(int gen) {
+        if (gen == 2) return for2G();
+        if (gen == 3) return for3G();
+        if (gen == 4) return for35G();
+        if (gen == 5) return for4G();
+        if (gen == 6) return for4GPlus();
+        if (gen == 7) return for5G();
+        return NetworkConfig();
+    }
+
+    // Active profile for a generation: built-in defaults unless loadFile() succeeded.
+    static const NetworkConfig& profile(int gen) {
+        if (gen < MIN_GEN || gen > MAX_GEN) gen = MIN_GEN;
+        return table()[gen];
+    }
+
+    // 🔑 Parses and validates the whole file once; the active table is only
+    // replaced if every block is valid. Returns false if the file is missing.
+    static bool loadFile(const char* path) {
+        long fd = syscall3(2, (long)path, 0, 0); // SYS_OPEN, O_RDONLY
+        if (fd < 0) return false;
+        static char buf[MAX_FILE_BYTES + 1];
+        long total = 0;
+        while (total < MAX_FILE_BYTES) {
+            long n = syscall3(0, fd, (long)(buf + total), MAX_FILE_BYTES - total);
+            if (n <= 0) break;
+            total += n;
+        }
+        syscall3(3, fd, 0, 0); // SYS_CLOSE
+        if (total >= MAX_FILE_BYTES) throw InvalidConfigException(0);
+        buf[total] = '\0';
+
+        NetworkConfig parsed[MAX_GEN + 1];
+        parse(buf, total, parsed);
+        NetworkConfig* active = table();
+        for (int g = MIN_GEN; g <= MAX_GEN; ++g) active[g] = parsed[g];
+        return true;
+    }
+
+    // Format (one directive per line, '#' starts a comment):
+    //   gen <2-7>                      starts a block, seeded from built-in defaults
+    //   name <text> | protocol <text>
+    //   spectrum <mhz> | channel_bw <mhz> | users_per_channel <n>
+    //   antenna_factor <n> | mimo <0|1> | messages <n> | fallback <0|2-7>
+    //   service <voice> <sms> <data> <voice+data>
+    //   band <start_mhz> <step_mhz> <count> <max_users>   (first band replaces defaults)
+    //   capacity <fixed|shannon|cqi> | sinr <mean_db> <spread_db> | carrier_khz <n>
+    //   demand <voice> <sms> <data> <voice+data>   (kbit/s)
+    //   aggregation <max_component_carriers>        (1-16, 1 = off)
+    //   priority <voice> <sms> <data> <voice+data>  (QoS class, 0-15, higher preempts lower)
+    static void parse(const char* buf, long len, NetworkConfig out[MAX_GEN + 1]) {
+        for (int g = MIN_GEN; g <= MAX_GEN; ++g) out[g] = forGeneration(g);
+        bool bands_overridden[MAX_GEN + 1] = {false};
+        NetworkConfig* cur = nullptr;
+        int line_no = 0;
+        long pos = 0;
+        while (pos < len) {
+            ++line_no;
+            long end = pos;
+            while (end < len && buf[end] != '\n') ++end;
+            Cursor c(buf, pos, end);
+            pos = end + 1;
+
+            c.skipSpaces();
+            if (c.atEnd() || c.peek() == '#') continue;
+
+            char key[24];
+            c.word(key, sizeof(key));
+            if (equals(key, "gen")) {
+                long g;
+                if (!c.integer(g) || g < MIN_GEN || g > MAX_GEN) throw InvalidConfigException(line_no);
+                cur = &out[g];
+            } else if (!cur) {
+                throw InvalidConfigException(line_no);
+            } else if (equals(key, "name")) {
+                c.rest(cur->name, sizeof(cur->name));
+            } else if (equals(key, "protocol")) {
+                c.rest(cur->protocol, sizeof(cur->protocol));
+            } else if (equals(key, "spectrum")) {
+                if (!c.decimal(cur->total_spectrum_mhz)) throw InvalidConfigException(line_no);
+            } else if (equals(key, "channel_bw")) {
+                if (!c.decimal(cur->channel_bandwidth_mhz)) throw InvalidConfigException(line_no);
+            } else if (equals(key, "users_per_channel")) {
+                if (!c.intField(cur->users_per_channel)) throw InvalidConfigException(line_no);
+            } else if (equals(key, "antenna_factor")) {
+                if (!c.intField(cur->antenna_factor)) throw InvalidConfigException(line_no);
+            } else if (equals(key, "mimo")) {
+                int m;
+                if (!c.intField(m) || m < 0 || m > 1) throw InvalidConfigException(line_no);
+                cur->mimo_enabled = (m == 1);
+            } else if (equals(key, "fallback")) {
+                int f;
+                if (!c.intField(f) || (f != 0 && (f < MIN_GEN || f > MAX_GEN)) || f == cur->generation)
+                    throw InvalidConfigException(line_no);
+                cur->fallback_gen = f;
+            } else if (equals(key, "messages")) {
+                if (!c.intField(cur->messages_per_user)) throw InvalidConfigException(line_no);
+            } else if (equals(key, "service")) {
+                for (int s = 1; s < MAX_SERVICES; ++s)
+                    if (!c.intField(cur->service_messages[s])) throw InvalidConfigException(line_no);
+            } else if (equals(key, "capacity")) {
+                char kind[16];
+                c.word(kind, sizeof(kind));
+                if (equals(kind, "fixed")) cur->capacity_kind = CAPACITY_FIXED;
+                else if (equals(kind, "shannon")) cur->capacity_kind = CAPACITY_SHANNON;
+                else if (equals(kind, "cqi")) cur->capacity_kind = CAPACITY_CQI;
+                else throw InvalidConfigException(line_no);
+            } else if (equals(key, "sinr")) {
+                if (!c.signedDecimal(cur->sinr_mean_db) || !c.decimal(cur->sinr_spread_db))
+                    throw InvalidConfigException(line_no);
+            } else if (equals(key, "carrier_khz")) {
+                if (!c.intField(cur->carrier_khz)) throw InvalidConfigException(line_no);
+            } else if (equals(key, "demand")) {
+                for (int s = 1; s < MAX_SERVICES; ++s)
+                    if (!c.intField(cur->service_kbps[s])) throw InvalidConfigException(line_no);
+            } else if (equals(key, "priority")) {
+                int p[MAX_SERVICES];
+                for (int s = 1; s < MAX_SERVICES; ++s)
+                    if (!c.intField(p[s]) || p[s] > MAX_PRIORITY) throw InvalidConfigException(line_no);
+                cur->setServicePriority(p[1], p[2], p[3], p[4]);
+            } else if (equals(key, "aggregation")) {
+                if (!c.intField(cur->max_carriers)) throw InvalidConfigException(line_no);
+            } else if (equals(key, "band")) {
+                if (!bands_overridden[cur->generation]) {
+                    cur->band_count = 0;
+                    bands_overridden[cur->generation] = true;
+                }
+                Band b;
+                if (!c.intField(b.start_mhz) || !c.intField(b.step_mhz) ||
+                    !c.intField(b.count) || !c.intField(b.max_users))
+                    throw InvalidConfigException(line_no);
+                if (cur->band_count >= MAX_BANDS) throw InvalidConfigException(line_no);
+                cur->bands[cur->band_count++] = b;
+            } else {
+                throw InvalidConfigException(line_no);
+            }
+            c.skipSpaces();
+            if (!c.atEnd() && c.peek() != '#') throw InvalidConfigException(line_no);
+        }
+        for (int g = MIN_GEN; g <= MAX_GEN; ++g) {
+            if (!out[g].isValid() || !fallbackEnds(out, g)) throw InvalidConfigException(0);
+        }
+    }
+
+    // The fallback chain from `gen` reaches 0 without revisiting a generation
+    static bool fallbackEnds(const NetworkConfig table[MAX_GEN + 1], int gen) {
+        unsigned int visited = 0;
+        for (int g = gen; g != 0; g = table[g].fallback_gen) {
+            if (visited & (1u << g)) return false;
+            visited |= 1u << g;
+        }
+        return true;
+    }
+
+    bool isValid() const {
+        if (name[0] == '\0' || protocol[0] == '\0') return false;
+        if (total_spectrum_mhz <= 0 || channel_bandwidth_mhz <= 0) return false;
+        if (users_per_channel <= 0 || antenna_factor <= 0 || messages_per_user <= 0) return false;
+        for (int s = 1; s < MAX_SERVICES; ++s)
+            if (service_messages[s] <= 0 || service_kbps[s] <= 0) return false;
+        if (carrier_khz <= 0 || sinr_mean_db < -50 || sinr_mean_db > 60) return false;
+        if (max_carriers < 1 || max_carriers > MAX_CARRIERS) return false;
+        if (band_count <= 0) return false;
+        long slots = 0;
+        for (int b = 0; b < band_count; ++b) {
+            const Band& band = bands[b];
+            if (band.start_mhz <= 0 || band.step_mhz <= 0 || band.count <= 0 || band.max_users <= 0)
+                return false;
+            if (band.start_mhz + (long)band.step_mhz * (band.count - 1) > MAX_FREQ_MHZ) return false;
+            slots += band.count;
+            // Bands must not share carriers
+            for (int o = 0; o < b; ++o) {
+                const Band& other = bands[o];
+                long a_end = band.start_mhz + (long)band.step_mhz * (band.count - 1);
+                long o_end = other.start_mhz + (long)other.step_mhz * (other.count - 1);
+                if (band.start_mhz <= o_end && other.start_mhz <= a_end) return false;
+            }
+        }
+        return slots <= MAX_SLOTS;
+    }
+
+    // Services outside 1..4 are billed as Voice+Data
+    static int serviceSlot(int service_type) {
+        return (service_type >= 1 && service_type < MAX_SERVICES) ? service_type : MAX_SERVICES - 1;
+    }
+
+    // Flat per-service cost
+    int messagesFor(int service_type) const { return service_messages[serviceSlot(service_type)]; }
+
+    int getSlotCount() const {
+        int slots = 0;
+        for (int b = 0; b < band_count; ++b) slots += bands[b].count;
+        return slots;
+    }
+
     int getMaxUsers() const {
         int channels = static_cast<int>(total_spectrum_mhz / channel_bandwidth_mhz);
         int total = channels * users_per_channel;
@@ -107,9 +394,147 @@ public:
     }
 
 private:
+    static const long MAX_FILE_BYTES = 65536;
+    static const long MAX_FREQ_MHZ = 100000; // matches the frequency prompt range
+
+    static NetworkConfig* table() {
+        static NetworkConfig configs[MAX_GEN + 1];
+        static bool initialized = false;
+        if (!initialized) {
+            for (int g = MIN_GEN; g <= MAX_GEN; ++g) configs[g] = forGeneration(g);
+            initialized = true;
+        }
+        return configs;
+    }
+
     void setName(const char* n) {
         int i = 0;
         while (n[i] && i < 15) { name[i] = n[i]; ++i; }
         name[i] = '\0';
     }
+
+    void setProtocol(const char* p) {
+        int i = 0;
+        while (p[i] && i < 63) { protocol[i] = p[i]; ++i; }
+        protocol[i] = '\0';
+    }
+
+    void setServiceMessages(int voice, int sms, int data, int voice_data) {
+        service_messages[0] = messages_per_user;
+        service_messages[1] = voice;
+        service_messages[2] = sms;
+        service_messages[3] = data;
+        service_messages[4] = voice_data;
+    }
+
+    // Unknown services rank as Voice+Data
+    void setServicePriority(int voice, int sms, int data, int voice_data) {
+        service_priority[0] = voice_data;
+        service_priority[1] = voice;
+        service_priority[2] = sms;
+        service_priority[3] = data;
+        service_priority[4] = voice_data;
+    }
+
+    // Voice+Data demands the sum of both
+    void setServiceKbps(int voice, int sms, int data) {
+        service_kbps[0] = voice + data;
+        service_kbps[1] = voice;
+        service_kbps[2] = sms;
+        service_kbps[3] = data;
+        service_kbps[4] = voice + data;
+    }
+
+    void addBand(int start, int step, int count, int max_users) {
+        bands[band_count].start_mhz = start;
+        bands[band_count].step_mhz = step;
+        bands[band_count].count = count;
+        bands[band_count].max_users = max_users;
+        ++band_count;
+    }
+
+    static bool equals(const char* a, const char* b) {
+        int i = 0;
+        while (a[i] && a[i] == b[i]) ++i;
+        return a[i] == b[i];
+    }
+
+    // Tokenizer over a single line [pos, end)
+    struct Cursor {
+        static const long MAX_FIELD = 100000000;   // numeric fields (decimals: all digits)
+        const char* buf;
+        long pos;
+        long end;
+        Cursor(const char* b, long p, long e) : buf(b), pos(p), end(e) {
+            if (end > pos && buf[end - 1] == '\r') --end;
+        }
+        bool atEnd() const { return pos >= end; }
+        char peek() const { return buf[pos]; }
+        void skipSpaces() { while (pos < end && (buf[pos] == ' ' || buf[pos] == '\t')) ++pos; }
+        void word(char* out, int size) {
+            skipSpaces();
+            int i = 0;
+            while (pos < end && buf[pos] != ' ' && buf[pos] != '\t' && i < size - 1) out[i++] = buf[pos++];
+            out[i] = '\0';
+        }
+        void rest(char* out, int size) {
+            skipSpaces();
+            long stop = end;
+            while (stop > pos && (buf[stop - 1] == ' ' || buf[stop - 1] == '\t')) --stop;
+            int i = 0;
+            while (pos < stop && i < size - 1) out[i++] = buf[pos++];
+            out[i] = '\0';
+            pos = end;
+        }
+        bool integer(long& value) {
+            skipSpaces();
+            if (pos >= end || buf[pos] < '0' || buf[pos] > '9') return false;
+            value = 0;
+            while (pos < end && buf[pos] >= '0' && buf[pos] <= '9') {
+                if (!pushDigit(value)) return false;
+            }
+            return pos >= end || buf[pos] == ' ' || buf[pos] == '\t';
+        }
+        // Appends the digit at pos, refusing (before it can wrap) past MAX_FIELD
+        bool pushDigit(long& value) {
+            int digit = buf[pos] - '0';
+            if (value > (MAX_FIELD - digit) / 10) return false;
+            value = value * 10 + digit;
+            ++pos;
+            return true;
+        }
+        bool intField(int& value) {
+            long v;
+            if (!integer(v)) return false;
+            value = static_cast<int>(v);
+            return true;
+        }
+        bool decimal(double& value) {
+            skipSpaces();
+            if (pos >= end || ((buf[pos] < '0' || buf[pos] > '9') && buf[pos] != '.')) return false;
+            // mantissa / 10^k keeps "0.01" bit-identical to the literal
+            long mantissa = 0;
+            double divisor = 1.0;
+            while (pos < end && buf[pos] >= '0' && buf[pos] <= '9') {
+                if (!pushDigit(mantissa)) return false;
+            }
+            if (pos < end && buf[pos] == '.') {
+                ++pos;
+                while (pos < end && buf[pos] >= '0' && buf[pos] <= '9' && divisor < 1e9) {
+                    if (!pushDigit(mantissa)) return false;
+                    divisor *= 10.0;
+                }
+            }
+            value = mantissa / divisor;
+            return pos >= end || buf[pos] == ' ' || buf[pos] == '\t';
+        }
+        bool signedDecimal(double& value) {
+            skipSpaces();
+            bool negative = pos < end && buf[pos] == '-';
+            if (negative) ++pos;
+            if (!decimal(value)) return false;
+            if (negative) value = -value;
+            return true;
+        }
+    };
 };
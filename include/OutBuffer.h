@@ -0,0 +1,70 @@
+#pragma once
+#include "basicIO.h"
+
+// Append-only text buffer flushed with a single write syscall. Appends past
+// the end are dropped and reported through overflowed().
+class OutBuffer {
+public:
+    OutBuffer(char* storage, long size) : buf(storage), cap(size), len(0), overflow(false) {}
+
+    OutBuffer& put(char c) {
+        if (len < cap) buf[len++] = c;
+        else overflow = true;
+        return *this;
+    }
+
+    OutBuffer& put(const char* text) {
+        while (*text) put(*text++);
+        return *this;
+    }
+
+    OutBuffer& putInt(long value) {
+        char digits[24];
+        int count = 0;
+        bool neg = value < 0;
+        unsigned long v = neg ? 0UL - static_cast<unsigned long>(value) : static_cast<unsigned long>(value);
+        do { digits[count++] = '0' + (v % 10); v /= 10; } while (v > 0);
+        if (neg) put('-');
+        while (count > 0) put(digits[--count]);
+        return *this;
+    }
+
+    // Fixed-point with `decimals` digits after the point
+    OutBuffer& putFixed(double value, int decimals) {
+        if (value < 0) { put('-'); value = -value; }
+        long scale = 1;
+        for (int i = 0; i < decimals; ++i) scale *= 10;
+        long scaled = static_cast<long>(value * scale + 0.5);
+        putInt(scaled / scale);
+        if (decimals > 0) {
+            put('.');
+            long frac = scaled % scale;
+            for (long div = scale / 10; div > 0; div /= 10) put('0' + static_cast<char>((frac / div) % 10));
+        }
+        return *this;
+    }
+
+    // Writes everything buffered to fd and empties the buffer
+    long flush(long fd) {
+        long written = 0;
+        while (written < len) {
+            long n = syscall3(1, fd, (long)(buf + written), len - written); // SYS_WRITE
+            if (n <= 0) break;
+            written += n;
+        }
+        len = 0;
+        return written;
+    }
+
+    void clear() { len = 0; overflow = false; }
+    const char* data() const { return buf; }
+    long size() const { return len; }
+    long capacity() const { return cap; }
+    bool overflowed() const { return overflow; }
+
+private:
+    char* buf;
+    long cap;
+    long len;
+    bool overflow;
+};
@@ -0,0 +1,130 @@
+#pragma once
+
+// 🔥 Overload control in front of a core's registration processing. The core
+// serves registrations one at a time in arrival order; each costs its
+// signalling messages at the core's message rate. Every arriving request is
+// offered to the active policy, which either queues it behind the core or
+// turns it away:
+//   NONE          - everything queues (the naive core: delay grows without bound)
+//   TOKEN_BUCKET  - admit while tokens last; refill at `rate` per second up to `burst`
+//   BACKOFF       - reject when the queue delay exceeds a threshold, telling the
+//                   device to back off for base * 2^(attempt - 1) (capped)
+//   BOUNDED_QUEUE - reject when `queue_limit` requests are already waiting
+// Time is simulated nanoseconds supplied by the caller, so the same control
+// works for storm replays and for live traffic.
+class OverloadControl {
+public:
+    enum Policy { POLICY_NONE, POLICY_TOKEN_BUCKET, POLICY_BACKOFF, POLICY_BOUNDED_QUEUE };
+    enum Decision { ACCEPT, REJECT, REJECT_BACKOFF };
+
+    struct Settings {
+        Policy policy;
+        long rate_per_sec;        // token bucket refill
+        long burst;               // token bucket depth
+        long queue_limit;         // bounded queue
+        long backoff_after_ns;    // backoff: queue delay that triggers rejection
+        long backoff_base_ns;
+        long backoff_max_ns;
+    };
+
+    // Sensible settings for a core that completes `registrations_per_sec`
+    static Settings defaults(Policy policy, long registrations_per_sec) {
+        if (registrations_per_sec < 1) registrations_per_sec = 1;
+        Settings s;
+        s.policy = policy;
+        s.rate_per_sec = registrations_per_sec * 9 / 10 > 0 ? registrations_per_sec * 9 / 10 : 1;
+        s.burst = registrations_per_sec / 10 > 0 ? registrations_per_sec / 10 : 1;
+        s.queue_limit = registrations_per_sec / 2 > 0 ? registrations_per_sec / 2 : 1;   // ~0.5 s of work
+        s.backoff_after_ns = 500000000L;
+        s.backoff_base_ns = 2000000000L;
+        s.backoff_max_ns = 32000000000L;
+        return s;
+    }
+
+    explicit OverloadControl(const Settings& s)
+        : settings(s), done(nullptr), cap(0), head(0), count(0), core_free_ns(0),
+          tokens(static_cast<double>(s.burst)), refill_ns(0), max_depth(0) {
+        grow();
+    }
+
+    ~OverloadControl() { delete[] done; }
+
+    OverloadControl(const OverloadControl&) = delete;
+    OverloadControl& operator=(const OverloadControl&) = delete;
+
+    // A request arriving at now_ns that needs service_ns of core time. On
+    // ACCEPT, start_ns is when the core begins it; on REJECT_BACKOFF,
+    // backoff_ns is how long the device is told to wait.
+    Decision offer(long now_ns, long service_ns, int attempt, long& start_ns, long& backoff_ns) {
+        drain(now_ns);
+        long wait = core_free_ns > now_ns ? core_free_ns - now_ns : 0;
+        switch (settings.policy) {
+        case POLICY_TOKEN_BUCKET:
+            tokens += static_cast<double>(now_ns - refill_ns) * settings.rate_per_sec / 1e9;
+            if (tokens > settings.burst) tokens = static_cast<double>(settings.burst);
+            refill_ns = now_ns;
+            if (tokens < 1.0) return REJECT;
+            tokens -= 1.0;
+            break;
+        case POLICY_BACKOFF:
+            if (wait > settings.backoff_after_ns) {
+                int shift = attempt > 1 ? (attempt - 1 < 20 ? attempt - 1 : 20) : 0;
+                backoff_ns = settings.backoff_base_ns << shift;
+                if (backoff_ns > settings.backoff_max_ns) backoff_ns = settings.backoff_max_ns;
+                return REJECT_BACKOFF;
+            }
+            break;
+        case POLICY_BOUNDED_QUEUE:
+            if (count >= settings.queue_limit) return REJECT;
+            break;
+        default:
+            break;
+        }
+        start_ns = now_ns + wait;
+        core_free_ns = start_ns + service_ns;
+        push(core_free_ns);
+        return ACCEPT;
+    }
+
+    // Requests accepted but not finished at the last offer
+    long getQueueDepth() const { return count; }
+    long getMaxQueueDepth() const { return max_depth; }
+    long getCoreFreeNs() const { return core_free_ns; }
+    const Settings& getSettings() const { return settings; }
+
+private:
+    Settings settings;
+    long* done;             // completion times of queued requests (FIFO, non-decreasing)
+    long cap;
+    long head;
+    long count;
+    long core_free_ns;
+    double tokens;
+    long refill_ns;
+    long max_depth;
+
+    void drain(long now_ns) {
+        while (count > 0 && done[head] <= now_ns) {
+            head = head + 1 == cap ? 0 : head + 1;
+            --count;
+        }
+    }
+
+    void push(long t) {
+        if (count == cap) grow();
+        long tail = head + count;
+        if (tail >= cap) tail -= cap;
+        done[tail] = t;
+        if (++count > max_depth) max_depth = count;
+    }
+
+    void grow() {
+        long bigger = cap > 0 ? cap * 2 : 1024;
+        long* next = new long[bigger];
+        for (long i = 0; i < count; ++i) next[i] = done[(head + i) % cap];
+        delete[] done;
+        done = next;
+        cap = bigger;
+        head = 0;
+    }
+};
@@ -0,0 +1,214 @@
+#pragma once
+#include <atomic>
+#include "Clock.h"
+#include "OutBuffer.h"
+
+// 🔥 Hot-path instrumentation: per-thread event counters and log-linear
+// latency histograms. Only compiled in when CELLSIM_PERF is defined (the
+// debug build); in release the PERF_* macros expand to nothing.
+//
+// Each thread owns a Block and updates it with plain relaxed load/store (no
+// locked RMW). Blocks live on a lock-free list so dump() can sum them while
+// threads keep running; a thread that exits releases its Block for reuse and
+// its counts stay in the totals.
+class Perf {
+public:
+    enum Counter {
+        ADMITTED,
+        REJECT_SLOT_FULL,
+        REJECT_CORE_FULL,
+        REJECT_INVALID_FREQ,
+        REJECT_USER_LIMIT,
+        REMOVED,
+        QUERIED,
+        IO_SYSCALLS,
+        PARSED_RECORDS,
+        COUNTER_COUNT
+    };
+
+    enum Timer {
+        T_ADMIT,
+        T_REMOVE,
+        T_QUERY,
+        T_PARSE,
+        TIMER_COUNT
+    };
+
+    // Buckets 0..15 hold exact values; above that every power of two is
+    // split into 8 linear sub-buckets (<= 12.5% relative error).
+    static const int LINEAR = 16;
+    static const int SUB_BITS = 3;
+    static const int BUCKETS = LINEAR + (64 - 4) * (1 << SUB_BITS);
+
+    static int bucketOf(unsigned long v) {
+        if (v < static_cast<unsigned long>(LINEAR)) return static_cast<int>(v);
+        int e = 63 - __builtin_clzl(v);
+        int sub = static_cast<int>((v >> (e - SUB_BITS)) & ((1 << SUB_BITS) - 1));
+        return LINEAR + (e - 4) * (1 << SUB_BITS) + sub;
+    }
+
+    static unsigned long bucketFloor(int b) {
+        if (b < LINEAR) return static_cast<unsigned long>(b);
+        int e = (b - LINEAR) / (1 << SUB_BITS) + 4;
+        unsigned long sub = (b - LINEAR) % (1 << SUB_BITS);
+        return (1UL << e) | (sub << (e - SUB_BITS));
+    }
+
+    // Lower bound of the bucket holding the pct-th percentile of n samples
+    static long percentile(const long* buckets, long n, int pct) {
+        long target = (n * pct + 99) / 100;
+        long seen = 0;
+        for (int i = 0; i < BUCKETS; ++i) {
+            seen += buckets[i];
+            if (seen >= target) return static_cast<long>(bucketFloor(i));
+        }
+        return 0;
+    }
+
+    struct Block {
+        std::atomic<long> counters[COUNTER_COUNT];
+        std::atomic<long> hist[TIMER_COUNT][BUCKETS];
+        std::atomic<long> sum_ns[TIMER_COUNT];
+        std::atomic<long> max_ns[TIMER_COUNT];
+        std::atomic<bool> in_use;
+        Block* next;
+    };
+
+    static void count(Counter c, long n = 1) { bump(local().counters[c], n); }
+
+    static void record(Timer t, long ns) {
+        if (ns < 0) ns = 0;
+        Block& b = local();
+        bump(b.hist[t][bucketOf(static_cast<unsigned long>(ns))], 1);
+        bump(b.sum_ns[t], ns);
+        if (ns > b.max_ns[t].load(std::memory_order_relaxed)) b.max_ns[t].store(ns, std::memory_order_relaxed);
+    }
+
+    // Records the lifetime of the scope into a timer (timestamp counter, no syscall)
+    class Scope {
+    public:
+        explicit Scope(Timer t) : timer(t), start(Clock::ticks()) {}
+        ~Scope() { record(timer, Clock::ticksToNs(Clock::ticks() - start)); }
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+    private:
+        Timer timer;
+        long start;
+    };
+
+    static long total(Counter c) {
+        long sum = 0;
+        for (Block* b = head().load(std::memory_order_acquire); b; b = b->next)
+            sum += b->counters[c].load(std::memory_order_relaxed);
+        return sum;
+    }
+
+    // Zeroes every block; concurrent updates during a reset may be lost
+    static void reset() {
+        for (Block* b = head().load(std::memory_order_acquire); b; b = b->next) clear(*b);
+    }
+
+    static void dump(OutBuffer& out) {
+        static const char* counter_names[COUNTER_COUNT] = {
+            "Admitted", "Rejected (slot full)", "Rejected (core full)", "Rejected (invalid freq)",
+            "Rejected (user limit)", "Removed", "Frequency queries", "basicIO syscalls", "Parsed records"};
+        static const char* timer_names[TIMER_COUNT] = {"admit", "remove", "query", "parse"};
+
+        out.put("\n--- Performance Stats ---\n");
+        for (int c = 0; c < COUNTER_COUNT; ++c) {
+            pad(out, counter_names[c], 26);
+            out.put(": ").putInt(total(static_cast<Counter>(c))).put('\n');
+        }
+        out.put("\nTimer      Count        Avg ns   p50      p90      p99      Max ns\n");
+        for (int t = 0; t < TIMER_COUNT; ++t) {
+            long buckets[BUCKETS];
+            long n = 0, sum = 0, max = 0;
+            for (int i = 0; i < BUCKETS; ++i) buckets[i] = 0;
+            for (Block* b = head().load(std::memory_order_acquire); b; b = b->next) {
+                for (int i = 0; i < BUCKETS; ++i) {
+                    long v = b->hist[t][i].load(std::memory_order_relaxed);
+                    buckets[i] += v;
+                    n += v;
+                }
+                sum += b->sum_ns[t].load(std::memory_order_relaxed);
+                long m = b->max_ns[t].load(std::memory_order_relaxed);
+                if (m > max) max = m;
+            }
+            if (n == 0) continue;
+            pad(out, timer_names[t], 11);
+            padInt(out, n, 13);
+            padInt(out, sum / n, 9);
+            padInt(out, percentile(buckets, n, 50), 9);
+            padInt(out, percentile(buckets, n, 90), 9);
+            padInt(out, percentile(buckets, n, 99), 9);
+            out.putInt(max).put('\n');
+        }
+    }
+
+private:
+    static void bump(std::atomic<long>& a, long n) {
+        a.store(a.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+    }
+
+    static void clear(Block& b) {
+        for (int c = 0; c < COUNTER_COUNT; ++c) b.counters[c].store(0, std::memory_order_relaxed);
+        for (int t = 0; t < TIMER_COUNT; ++t) {
+            for (int i = 0; i < BUCKETS; ++i) b.hist[t][i].store(0, std::memory_order_relaxed);
+            b.sum_ns[t].store(0, std::memory_order_relaxed);
+            b.max_ns[t].store(0, std::memory_order_relaxed);
+        }
+    }
+
+    static std::atomic<Block*>& head() {
+        static std::atomic<Block*> list(nullptr);
+        return list;
+    }
+
+    // Claims a released block, or pushes a new one onto the list
+    static Block* acquire() {
+        for (Block* b = head().load(std::memory_order_acquire); b; b = b->next) {
+            bool expected = false;
+            if (b->in_use.compare_exchange_strong(expected, true, std::memory_order_acq_rel)) return b;
+        }
+        Block* b = new Block;
+        clear(*b);
+        b->in_use.store(true, std::memory_order_relaxed);
+        b->next = head().load(std::memory_order_relaxed);
+        while (!head().compare_exchange_weak(b->next, b, std::memory_order_release, std::memory_order_relaxed)) {}
+        return b;
+    }
+
+    struct Owner {
+        Block* block;
+        Owner() : block(acquire()) {}
+        ~Owner() { block->in_use.store(false, std::memory_order_release); }
+    };
+
+    static Block& local() {
+        thread_local Owner owner;
+        return *owner.block;
+    }
+
+    static void pad(OutBuffer& out, const char* text, int width) {
+        int len = 0;
+        while (text[len]) out.put(text[len++]);
+        while (len++ < width) out.put(' ');
+    }
+
+    static void padInt(OutBuffer& out, long v, int width) {
+        int len = 1;
+        for (long x = v; x >= 10; x /= 10) ++len;
+        out.putInt(v);
+        do out.put(' '); while (len++ < width - 1);   // always keep one space between columns
+    }
+};
+
+#ifdef CELLSIM_PERF
+#define PERF_COUNT(counter) Perf::count(Perf::counter)
+#define PERF_COUNT_N(counter, n) Perf::count(Perf::counter, (n))
+#define PERF_SCOPE(timer) Perf::Scope perf_scope_##timer(Perf::timer)
+#else
+#define PERF_COUNT(counter) ((void)0)
+#define PERF_COUNT_N(counter, n) ((void)0)
+#define PERF_SCOPE(timer) ((void)0)
+#endif
@@ -0,0 +1,142 @@
+#pragma once
+#include "SlotHeap.h"
+
+// Preemption index: one binary min-heap of admitted users per slot, keyed by
+// (priority, -cost), so the lowest-priority, most expensive user on a slot is
+// its heap top. A SlotHeap over the slot tops gives the cheapest victim
+// anywhere in O(1) (used when the core, not a slot, is full). Adds and
+// victim pops are O(log n); removing an arbitrary user searches its slot's
+// heap, which is no worse than the user-table shift that removal already pays.
+// Entries hold user indices, so renumber() follows the manager's shift.
+class QosHeap {
+public:
+    static const long NONE = SlotHeap::FULL;
+
+    QosHeap() : heaps(nullptr), sizes(nullptr), caps(nullptr), slot_count(0) {}
+    ~QosHeap() { release(); }
+
+    QosHeap(const QosHeap&) = delete;
+    QosHeap& operator=(const QosHeap&) = delete;
+
+    // Lower key = evicted first: priority class, then the larger cost
+    static long key(int priority, long cost) {
+        if (cost < 0) cost = 0;
+        if (cost > COST_MASK) cost = COST_MASK;
+        return (static_cast<long>(priority) << COST_BITS) | (COST_MASK - cost);
+    }
+    static int priorityOf(long key) { return static_cast<int>(key >> COST_BITS); }
+
+    void reset(int slots) {
+        release();
+        slot_count = slots;
+        heaps = new Entry*[slots];
+        sizes = new int[slots];
+        caps = new int[slots];
+        for (int s = 0; s < slots; ++s) {
+            heaps[s] = nullptr;
+            sizes[s] = 0;
+            caps[s] = 0;
+        }
+        tops.reset(slots);
+        tops.heapify();
+    }
+
+    void add(int slot, int user, long k) {
+        if (sizes[slot] == caps[slot]) grow(slot);
+        Entry* h = heaps[slot];
+        int i = sizes[slot]++;
+        h[i] = Entry{k, user};
+        siftUp(h, i);
+        tops.set(slot, h[0].key);
+    }
+
+    void remove(int slot, int user) {
+        Entry* h = heaps[slot];
+        int n = sizes[slot];
+        for (int i = 0; i < n; ++i) {
+            if (h[i].user != user) continue;
+            h[i] = h[--sizes[slot]];
+            if (i < sizes[slot]) {
+                siftUp(h, i);
+                siftDown(h, i, sizes[slot]);
+            }
+            tops.set(slot, sizes[slot] > 0 ? h[0].key : NONE);
+            return;
+        }
+    }
+
+    // users[] dropped index `user`: every higher index moves down one
+    void renumber(int user) {
+        for (int s = 0; s < slot_count; ++s) {
+            Entry* h = heaps[s];
+            for (int i = 0; i < sizes[s]; ++i) h[i].user -= h[i].user > user;
+        }
+    }
+
+    // Best victim on a slot (-1 if empty) and its key
+    int top(int slot) const { return sizes[slot] > 0 ? heaps[slot][0].user : -1; }
+    long topKey(int slot) const { return sizes[slot] > 0 ? heaps[slot][0].key : NONE; }
+
+    // Slot holding the best victim overall, or -1
+    int bestSlot() const { return tops.top(); }
+
+private:
+    static const int COST_BITS = 40;
+    static const long COST_MASK = (1L << COST_BITS) - 1;
+
+    struct Entry {
+        long key;
+        int user;
+    };
+
+    Entry** heaps;
+    int* sizes;
+    int* caps;
+    int slot_count;
+    SlotHeap tops;
+
+    // Ties on key evict the most recent user (highest index) first
+    static bool before(const Entry& a, const Entry& b) {
+        return a.key < b.key || (a.key == b.key && a.user > b.user);
+    }
+
+    static void siftUp(Entry* h, int i) {
+        while (i > 0) {
+            int parent = (i - 1) / 2;
+            if (!before(h[i], h[parent])) break;
+            Entry t = h[i]; h[i] = h[parent]; h[parent] = t;
+            i = parent;
+        }
+    }
+
+    static void siftDown(Entry* h, int i, int n) {
+        while (true) {
+            int best = i, l = 2 * i + 1, r = l + 1;
+            if (l < n && before(h[l], h[best])) best = l;
+            if (r < n && before(h[r], h[best])) best = r;
+            if (best == i) break;
+            Entry t = h[i]; h[i] = h[best]; h[best] = t;
+            i = best;
+        }
+    }
+
+    void grow(int slot) {
+        int cap = caps[slot] > 0 ? caps[slot] * 2 : 8;
+        Entry* bigger = new Entry[cap];
+        for (int i = 0; i < sizes[slot]; ++i) bigger[i] = heaps[slot][i];
+        delete[] heaps[slot];
+        heaps[slot] = bigger;
+        caps[slot] = cap;
+    }
+
+    void release() {
+        for (int s = 0; s < slot_count; ++s) delete[] heaps[s];
+        delete[] heaps;
+        delete[] sizes;
+        delete[] caps;
+        heaps = nullptr;
+        sizes = nullptr;
+        caps = nullptr;
+        slot_count = 0;
+    }
+};
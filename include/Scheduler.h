@@ -0,0 +1,311 @@
+#pragma once
+#include "GenerationManager.h"
+
+// 🔥 Per-TTI downlink scheduler for the OFDM generations (4G, 4G+, 5G).
+// Instead of a fixed user count per slot, every 1 ms TTI hands the slot's
+// resource blocks to its users by round-robin or proportional-fair (PF)
+// policy. Each user gets a fading channel, and throughput follows from the
+// allocation.
+//
+// Per-user state is structure-of-arrays, padded to whole 4-lane vectors, so
+// fading, the PF metric and the throughput average are computed four users
+// at a time (SSE through GCC vector extensions, no intrinsics headers). PF
+// picks the best K users by bucket select: a histogram of the metric finds
+// the cut-off bucket, users above it are taken in one branchless pass, and
+// only the users tied in the cut-off bucket go through a small heap.
+class TtiScheduler {
+public:
+    enum Policy { POLICY_ROUND_ROBIN, POLICY_PROPORTIONAL_FAIR };
+
+    static const int TTI_US = 1000;
+    static const int RB_BANDWIDTH_KHZ = 180;   // 12 subcarriers x 15 kHz
+
+    // Resource blocks per carrier and TTI; 0 for non-OFDM generations
+    static int resourceBlocksFor(int gen) {
+        if (gen == 5 || gen == 6) return 100;   // 20 MHz LTE carrier
+        if (gen == 7) return 273;               // 100 MHz NR carrier, 30 kHz SCS
+        return 0;
+    }
+
+    TtiScheduler(int resource_blocks, int capacity)
+        : rbs(resource_blocks), cap(capacity), n(0), cursor(0), ttis(0), served_bits(0) {
+        int padded = pad(cap);
+        mean = new float[padded];
+        rate = new float[padded];
+        metric = new float[padded];
+        avg = new float[padded];
+        seed = new unsigned int[padded];
+        total = new double[padded];
+        heap = new Pick[rbs > 0 ? rbs : 1];
+        bucket = new int[padded];
+        ties = new int[padded];
+        clear();
+    }
+
+    ~TtiScheduler() {
+        delete[] mean;
+        delete[] rate;
+        delete[] metric;
+        delete[] avg;
+        delete[] seed;
+        delete[] total;
+        delete[] heap;
+        delete[] bucket;
+        delete[] ties;
+    }
+
+    TtiScheduler(const TtiScheduler&) = delete;
+    TtiScheduler& operator=(const TtiScheduler&) = delete;
+
+    void clear() {
+        n = 0;
+        cursor = 0;
+        ttis = 0;
+        served_bits = 0;
+        for (int i = 0; i < pad(cap); ++i) setLane(i, 0.0f, 1);
+    }
+
+    // Adds a user whose channel averages `bits_per_rb` per resource block
+    // and TTI; returns its index or -1 when full
+    int addUser(float bits_per_rb, unsigned int channel_seed) {
+        if (n >= cap) return -1;
+        setLane(n, bits_per_rb, channel_seed | 1);
+        return n++;
+    }
+
+    // Loads every user holding the slot (aggregated users included). Channel
+    // quality is a deterministic per-user draw between 0.15 and 5.5 bit/s/Hz
+    // (cell edge to cell centre).
+    int loadSlot(const GenerationManager& manager, int slot_idx) {
+        clear();
+        int freq = manager.getSlotFrequency(slot_idx);
+        for (int i = 0; i < manager.getUserCount(); ++i) {
+            if (!manager.getUser(i).holdsSlot(slot_idx)) continue;
+            unsigned long h = mix(static_cast<unsigned long>(i + 1) * 0x9E3779B97F4A7C15UL + freq);
+            float efficiency = 0.15f + 5.35f * static_cast<float>(h >> 40) / 16777216.0f;
+            if (addUser(efficiency * RB_BANDWIDTH_KHZ, static_cast<unsigned int>(h)) < 0) break;
+        }
+        return n;
+    }
+
+    // Runs one TTI; returns the bits delivered in it
+    double tick(Policy policy) {
+        if (n == 0 || rbs <= 0) return 0;
+        fade(policy == POLICY_PROPORTIONAL_FAIR);
+        int k = n < rbs ? n : rbs;
+        if (k == n) {
+            for (int i = 0; i < n; ++i) { heap[i].user = i; heap[i].metric = 0; }
+        } else if (policy == POLICY_ROUND_ROBIN) {
+            for (int j = 0; j < k; ++j) heap[j].user = (cursor + j) % n;
+            cursor = (cursor + k) % n;
+        } else {
+            selectBest(k);
+        }
+        double bits = 0;
+        for (int j = 0; j < k; ++j) {
+            int share = rbs / k + (j < rbs % k ? 1 : 0);
+            int u = heap[j].user;
+            float served = rate[u] * share;
+            avg[u] += ALPHA * served;
+            total[u] += served;
+            bits += served;
+        }
+        served_bits += bits;
+        ++ttis;
+        return bits;
+    }
+
+    void run(Policy policy, long count) {
+        for (long t = 0; t < count; ++t) tick(policy);
+    }
+
+    int getUserCount() const { return n; }
+    int getResourceBlocks() const { return rbs; }
+    long getTtis() const { return ttis; }
+    double getServedBits() const { return served_bits; }
+    double getUserBits(int i) const { return total[i]; }
+
+    // Mean cell throughput since clear(), in Mbit/s
+    double getThroughputMbps() const {
+        return ttis > 0 ? served_bits / (static_cast<double>(ttis) * TTI_US) : 0.0;
+    }
+
+    // Jain's index over per-user delivered bits: 1 = perfectly even
+    double getFairness() const {
+        double sum = 0, squares = 0;
+        for (int i = 0; i < n; ++i) {
+            sum += total[i];
+            squares += total[i] * total[i];
+        }
+        return squares > 0 ? (sum * sum) / (n * squares) : 0.0;
+    }
+
+private:
+    typedef float v4f __attribute__((vector_size(16)));
+    typedef int v4i __attribute__((vector_size(16)));
+    typedef unsigned int v4u __attribute__((vector_size(16)));
+
+    static constexpr float ALPHA = 0.01f;   // PF averaging window of 100 TTIs
+    static const int BUCKETS = 1024;        // PF metric histogram resolution
+
+    struct Pick {
+        float metric;
+        int user;
+    };
+
+    int rbs;
+    int cap;
+    int n;
+    int cursor;   // next round-robin user
+    long ttis;
+    double served_bits;
+    float* mean;           // average bits per RB
+    float* rate;           // this TTI's bits per RB
+    float* metric;         // PF metric for this TTI
+    float* avg;            // EWMA of delivered bits per TTI
+    unsigned int* seed;    // xorshift32 fading state
+    double* total;         // bits delivered since clear()
+    Pick* heap;            // selected users this TTI (heap while ranking ties)
+    int* bucket;           // PF metric histogram bucket per user
+    int* ties;             // users in the cut-off bucket
+    int counts[4][BUCKETS];
+
+    static int pad(int count) { return (count + 3) & ~3; }
+
+    static unsigned long mix(unsigned long x) {
+        x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9UL;
+        x = (x ^ (x >> 27)) * 0x94D049BB133111EBUL;
+        return x ^ (x >> 31);
+    }
+
+    void setLane(int i, float bits_per_rb, unsigned int channel_seed) {
+        mean[i] = bits_per_rb;
+        rate[i] = 0;
+        metric[i] = 0;                                        // padding lanes never win
+        avg[i] = bits_per_rb > 0 ? bits_per_rb : 1.0f;
+        seed[i] = channel_seed;
+        total[i] = 0;
+    }
+
+    // New fading sample per user (uniform 0.5x-1.5x of the mean), the
+    // averaging decay and, for PF, metric = rate / average. Decaying before
+    // the metric scales every average by the same factor, so the ranking is
+    // unchanged and one pass suffices.
+    void fade(bool pf) {
+        const v4f decay = {1 - ALPHA, 1 - ALPHA, 1 - ALPHA, 1 - ALPHA};
+        const v4f half = {0.5f, 0.5f, 0.5f, 0.5f};
+        const v4f unit = {1.0f / 16777216, 1.0f / 16777216, 1.0f / 16777216, 1.0f / 16777216};
+        int lanes = pad(n);
+        for (int i = 0; i < lanes; i += 4) {
+            v4u s = *reinterpret_cast<v4u*>(seed + i);
+            s ^= s << 13;
+            s ^= s >> 17;
+            s ^= s << 5;
+            *reinterpret_cast<v4u*>(seed + i) = s;
+            v4f u = __builtin_convertvector(s >> 8, v4f) * unit;
+            v4f r = *reinterpret_cast<v4f*>(mean + i) * (u + half);
+            *reinterpret_cast<v4f*>(rate + i) = r;
+            v4f a = *reinterpret_cast<v4f*>(avg + i) * decay;
+            *reinterpret_cast<v4f*>(avg + i) = a;
+            if (pf) *reinterpret_cast<v4f*>(metric + i) = r / a;
+        }
+        for (int i = n; i < lanes; ++i) {   // padding: keep 0 / 1, never denormal
+            metric[i] = 0;
+            avg[i] = 1.0f;
+        }
+    }
+
+    // Top-k users by metric into heap[0, k)
+    void selectBest(int k) {
+        int lanes = pad(n);
+        v4f lo = {metric[0], metric[0], metric[0], metric[0]};
+        v4f hi = lo;
+        for (int i = 0; i < n - 3; i += 4) {   // whole groups only: padding is 0
+            v4f m = *reinterpret_cast<v4f*>(metric + i);
+            lo = m < lo ? m : lo;
+            hi = m > hi ? m : hi;
+        }
+        float low = lo[0], high = hi[0];
+        for (int l = 1; l < 4; ++l) {
+            if (lo[l] < low) low = lo[l];
+            if (hi[l] > high) high = hi[l];
+        }
+        for (int i = n & ~3; i < n; ++i) {
+            if (metric[i] < low) low = metric[i];
+            if (metric[i] > high) high = metric[i];
+        }
+        if (!(high > low)) {   // all equal: any k will do
+            for (int j = 0; j < k; ++j) heap[j].user = j;
+            return;
+        }
+
+        float scale = (BUCKETS - 1) / (high - low);
+        const v4f base = {low, low, low, low};
+        const v4f mul = {scale, scale, scale, scale};
+        const v4f zero = {0, 0, 0, 0};
+        for (int i = 0; i < lanes; i += 4) {
+            v4f b = (*reinterpret_cast<v4f*>(metric + i) - base) * mul;
+            b = b > zero ? b : zero;
+            *reinterpret_cast<v4i*>(bucket + i) = __builtin_convertvector(b, v4i);
+        }
+        // Four interleaved histograms: PF keeps metrics close together, and
+        // back-to-back increments of one counter would serialise
+        for (int h = 0; h < 4; ++h)
+            for (int b = 0; b < BUCKETS; ++b) counts[h][b] = 0;
+        const int* bin = bucket;   // local copy: the counter stores cannot alias it
+        for (int i = 0; i < lanes; i += 4) {
+            ++counts[0][bin[i]];
+            ++counts[1][bin[i + 1]];
+            ++counts[2][bin[i + 2]];
+            ++counts[3][bin[i + 3]];
+        }
+        counts[0][0] -= lanes - n;   // padding lanes land in bucket 0
+        for (int b = 0; b < BUCKETS; ++b) counts[0][b] += counts[1][b] + counts[2][b] + counts[3][b];
+
+        int cut = BUCKETS - 1;
+        int above = 0;
+        while (above + counts[0][cut] < k) above += counts[0][cut--];
+        int need = k - above;   // taken from the cut-off bucket, 1..counts[0][cut]
+
+        // Only ~k of n users reach the cut-off bucket: skip 4-lane groups
+        // that have none with one compare
+        const v4i floor = {cut, cut, cut, cut};
+        int taken = need;
+        int tied = 0;
+        for (int i = 0; i < lanes; i += 4) {
+            v4i hit = *reinterpret_cast<const v4i*>(bin + i) >= floor;
+            if (!(hit[0] | hit[1] | hit[2] | hit[3])) continue;
+            for (int l = i; l < i + 4 && l < n; ++l) {
+                if (bin[l] > cut) heap[taken++].user = l;
+                else if (bin[l] == cut) ties[tied++] = l;
+            }
+        }
+        for (int j = 0; j < need; ++j) {
+            heap[j].metric = metric[ties[j]];
+            heap[j].user = ties[j];
+        }
+        if (tied == need) return;
+        for (int j = need / 2 - 1; j >= 0; --j) siftDown(j, need);
+        for (int t = need; t < tied; ++t) offer(ties[t], need);
+    }
+
+    void offer(int user, int k) {
+        if (metric[user] <= heap[0].metric) return;
+        heap[0].metric = metric[user];
+        heap[0].user = user;
+        siftDown(0, k);
+    }
+
+    void siftDown(int j, int k) {
+        Pick item = heap[j];
+        while (true) {
+            int child = 2 * j + 1;
+            if (child >= k) break;
+            if (child + 1 < k && heap[child + 1].metric < heap[child].metric) ++child;
+            if (heap[child].metric >= item.metric) break;
+            heap[j] = heap[child];
+            j = child;
+        }
+        heap[j] = item;
+    }
+};
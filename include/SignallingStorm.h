@@ -0,0 +1,198 @@
+#pragma once
+#include "NetworkConfig.h"
+#include "OverloadControl.h"
+#include "Perf.h"
+#include "Clock.h"
+
+// 🔥 Re-registration storm after an outage: every device of a generation
+// comes back within a short window and registers with the core. Each device
+// has a service (uniform mix) and its registration costs that service's
+// signalling messages at the core's message rate. A device that is turned
+// away retries after its retry timer (or the backoff the core sent). If its
+// request waits in the queue past its timeout, it gives up and retries, but
+// the core still spends time on the stale request. After max_attempts failed
+// tries the device is abandoned.
+//
+// This is a discrete-event run in simulated time. First arrivals are
+// generated in time order, and only pending retries go through a binary
+// heap, so one attempt costs a heap operation plus an O(1) overload decision.
+class SignallingStorm {
+public:
+    struct Settings {
+        long devices;
+        long spread_ns;          // devices return uniformly over this window
+        long core_msgs_per_sec;  // core signalling throughput
+        long timeout_ns;         // a device stops waiting for an answer after this
+        long retry_ns;           // wait after a plain rejection or timeout
+        int max_attempts;
+    };
+
+    struct Result {
+        long attempts;
+        long registered;
+        long rejected;           // turned away by the overload control
+        long timed_out;          // answered after the device gave up
+        long abandoned;          // devices that ran out of attempts
+        long busy_ns;            // core time spent serving requests
+        long wasted_ns;          // ... of which on timed-out requests
+        long finish_ns;          // last registration completes
+        long t99_ns;             // 99% of devices registered (-1 = never)
+        long max_queue;
+        long delay_p50_ns;       // queue delay of accepted requests
+        long delay_p99_ns;
+        long delay_max_ns;
+        double registrations_per_sec;   // simulated: registered / finish time
+        long wall_ns;
+        double attempts_per_sec;        // simulator throughput (wall clock)
+    };
+
+    static Settings defaults(long devices) {
+        Settings s;
+        s.devices = devices;
+        s.spread_ns = 1000000000L;         // 1 s
+        s.core_msgs_per_sec = 1000000;
+        s.timeout_ns = 15000000000L;       // 15 s (T3410)
+        s.retry_ns = 10000000000L;         // 10 s (T3411)
+        s.max_attempts = 5;
+        return s;
+    }
+
+    SignallingStorm(int gen, const Settings& s) : settings(s), heap(nullptr), heap_size(0) {
+        if (settings.devices < 0) settings.devices = 0;
+        if (settings.devices > MAX_DEVICES) settings.devices = MAX_DEVICES;
+        if (settings.core_msgs_per_sec < 1) settings.core_msgs_per_sec = 1;
+        if (settings.max_attempts < 1) settings.max_attempts = 1;
+        const NetworkConfig& cfg = NetworkConfig::profile(gen);
+        long total = 0;
+        for (int svc = 1; svc <= SERVICES; ++svc) {
+            long messages = cfg.messagesFor(svc);
+            total += messages;
+            service_ns[svc - 1] = messages * 1000000000L / settings.core_msgs_per_sec;
+        }
+        registrations_per_sec = total > 0 ? settings.core_msgs_per_sec * SERVICES / total : settings.core_msgs_per_sec;
+        heap = new Event[settings.devices > 0 ? settings.devices : 1];
+    }
+
+    ~SignallingStorm() { delete[] heap; }
+
+    SignallingStorm(const SignallingStorm&) = delete;
+    SignallingStorm& operator=(const SignallingStorm&) = delete;
+
+    // Registrations the core completes per second under the service mix
+    long getRegistrationsPerSec() const { return registrations_per_sec; }
+
+    Result run(const OverloadControl::Settings& policy) {
+        OverloadControl control(policy);
+        Result r = {};
+        r.t99_ns = -1;
+        long buckets[Perf::BUCKETS];
+        for (int b = 0; b < Perf::BUCKETS; ++b) buckets[b] = 0;
+        long accepted = 0;
+        long target99 = (settings.devices * 99 + 99) / 100;
+        heap_size = 0;
+        long next_device = 0;
+        long wall_start = Clock::nowNs();
+
+        while (next_device < settings.devices || heap_size > 0) {
+            Event e;
+            long arrival = next_device < settings.devices ? settings.spread_ns * next_device / settings.devices
+                                                          : LAST;
+            if (heap_size > 0 && heap[0].time < arrival) {
+                e = popEvent();
+            } else {
+                e = Event{arrival, static_cast<int>(next_device++), 1};
+            }
+            ++r.attempts;
+            long service = service_ns[hash(e.device, 0) % SERVICES];
+            long start = 0, backoff = 0;
+            OverloadControl::Decision d = control.offer(e.time, service, e.attempt, start, backoff);
+            if (d == OverloadControl::ACCEPT) {
+                long wait = start - e.time;
+                ++buckets[Perf::bucketOf(static_cast<unsigned long>(wait))];
+                ++accepted;
+                if (wait > r.delay_max_ns) r.delay_max_ns = wait;
+                r.busy_ns += service;
+                if (wait + service <= settings.timeout_ns) {
+                    r.finish_ns = start + service;
+                    if (++r.registered == target99) r.t99_ns = r.finish_ns;
+                    continue;
+                }
+                ++r.timed_out;
+                r.wasted_ns += service;
+                retry(r, e, e.time + settings.timeout_ns);
+            } else {
+                ++r.rejected;
+                retry(r, e, e.time + (d == OverloadControl::REJECT_BACKOFF ? backoff : settings.retry_ns));
+            }
+        }
+
+        r.wall_ns = Clock::nowNs() - wall_start;
+        r.max_queue = control.getMaxQueueDepth();
+        r.delay_p50_ns = Perf::percentile(buckets, accepted, 50);
+        r.delay_p99_ns = Perf::percentile(buckets, accepted, 99);
+        r.registrations_per_sec = r.finish_ns > 0 ? r.registered * 1e9 / r.finish_ns : 0.0;
+        r.attempts_per_sec = r.wall_ns > 0 ? r.attempts * 1e9 / r.wall_ns : 0.0;
+        return r;
+    }
+
+private:
+    static const int SERVICES = 4;
+    static const long MAX_DEVICES = 0x7fffffffL;
+    static const long LAST = 0x7fffffffffffffffL;
+
+    struct Event {           // 16 bytes: a 10M-device storm keeps its heap at 160 MB
+        long time;
+        int device;
+        int attempt;
+    };
+
+    Settings settings;
+    long service_ns[SERVICES];
+    long registrations_per_sec;
+    Event* heap;             // pending retries, at most one per device
+    long heap_size;
+
+    static unsigned long hash(long device, int attempt) {
+        unsigned long x = static_cast<unsigned long>(device) * 0x9E3779B97F4A7C15UL + static_cast<unsigned long>(attempt);
+        x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9UL;
+        x = (x ^ (x >> 27)) * 0x94D049BB133111EBUL;
+        return x ^ (x >> 31);
+    }
+
+    // Schedules the device's next try with up to 50% jitter, or abandons it
+    void retry(Result& r, const Event& e, long at) {
+        if (e.attempt >= settings.max_attempts) {
+            ++r.abandoned;
+            return;
+        }
+        long jitter = static_cast<long>(hash(e.device, e.attempt) % static_cast<unsigned long>(settings.retry_ns / 2 + 1));
+        pushEvent(Event{at + jitter, e.device, e.attempt + 1});
+    }
+
+    void pushEvent(const Event& e) {
+        long i = heap_size++;
+        while (i > 0) {
+            long parent = (i - 1) / 2;
+            if (heap[parent].time <= e.time) break;
+            heap[i] = heap[parent];
+            i = parent;
+        }
+        heap[i] = e;
+    }
+
+    Event popEvent() {
+        Event top = heap[0];
+        Event last = heap[--heap_size];
+        long i = 0;
+        while (true) {
+            long child = 2 * i + 1;
+            if (child >= heap_size) break;
+            if (child + 1 < heap_size && heap[child + 1].time < heap[child].time) ++child;
+            if (last.time <= heap[child].time) break;
+            heap[i] = heap[child];
+            i = child;
+        }
+        heap[i] = last;
+        return top;
+    }
+};
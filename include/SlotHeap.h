@@ -0,0 +1,99 @@
+#pragma once
+
+// Indexed binary min-heap over slot indices. Each slot has a key; updating a
+// slot's key is O(log S) and the best slot is always heap[0]. Slots keyed
+// FULL are never returned by top(). Ties break on the lower slot index so the
+// choice is deterministic.
+class SlotHeap {
+public:
+    static const long FULL = 0x7fffffffffffffffL;
+
+    SlotHeap() : heap(nullptr), pos(nullptr), keys(nullptr), size(0), capacity(0) {}
+    ~SlotHeap() {
+        delete[] heap;
+        delete[] pos;
+        delete[] keys;
+    }
+
+    SlotHeap(const SlotHeap&) = delete;
+    SlotHeap& operator=(const SlotHeap&) = delete;
+
+    // Starts a bulk load of n slots; call load() for each slot, then heapify()
+    void reset(int n) {
+        if (n > capacity) {
+            delete[] heap;
+            delete[] pos;
+            delete[] keys;
+            heap = new int[n];
+            pos = new int[n];
+            keys = new long[n];
+            capacity = n;
+        }
+        size = n;
+        for (int i = 0; i < n; ++i) {
+            heap[i] = i;
+            pos[i] = i;
+            keys[i] = FULL;
+        }
+    }
+
+    void load(int slot, long key) { keys[slot] = key; }
+
+    void heapify() {
+        for (int i = size / 2 - 1; i >= 0; --i) siftDown(i);
+    }
+
+    void set(int slot, long key) {
+        if (slot < 0 || slot >= size) return;
+        long old = keys[slot];
+        keys[slot] = key;
+        if (key < old) siftUp(pos[slot]);
+        else if (key > old) siftDown(pos[slot]);
+    }
+
+    // Best slot, or -1 when every slot is FULL
+    int top() const {
+        if (size == 0 || keys[heap[0]] == FULL) return -1;
+        return heap[0];
+    }
+
+    long key(int slot) const { return keys[slot]; }
+    int getSize() const { return size; }
+
+private:
+    int* heap;   // heap position -> slot
+    int* pos;    // slot -> heap position
+    long* keys;  // slot -> key
+    int size;
+    int capacity;
+
+    bool less(int a, int b) const {
+        return keys[a] < keys[b] || (keys[a] == keys[b] && a < b);
+    }
+
+    void swapAt(int i, int j) {
+        int a = heap[i], b = heap[j];
+        heap[i] = b; pos[b] = i;
+        heap[j] = a; pos[a] = j;
+    }
+
+    void siftUp(int i) {
+        while (i > 0) {
+            int parent = (i - 1) / 2;
+            if (!less(heap[i], heap[parent])) break;
+            swapAt(i, parent);
+            i = parent;
+        }
+    }
+
+    void siftDown(int i) {
+        while (true) {
+            int l = 2 * i + 1, r = l + 1, best = i;
+            if (l < size && less(heap[l], heap[best])) best = l;
+            if (r < size && less(heap[r], heap[best])) best = r;
+            if (best == i) break;
+            swapAt(i, best);
+            i = best;
+        }
+    }
+};
@@ -0,0 +1,158 @@
+#pragma once
+#include "NetworkConfig.h"
+
+// Carrier table for one generation. Slots are stored sorted by frequency and a
+// small band index maps frequency -> slot with a binary search over bands and
+// a direct index inside the band, so lookups stay O(log bands) for any grid size.
+// Occupancy changes go through adjust(), which keeps per-slot utilisation and
+// per-band / plan-wide totals current in O(1), so status views never rescan.
+class SpectrumPlan {
+public:
+    struct Slot {
+        int frequency_mhz;
+        int current_users;
+        int max_users;
+        long messages;   // total message weight of users on the slot
+        int band;        // index into the band table
+        int utilisation_pct;
+    };
+
+    struct BandRange {
+        int start_mhz;
+        int step_mhz;
+        int count;
+        int max_users;
+        int first_slot;
+        long used_users;   // running totals over the band's slots
+        long capacity;
+        int full_slots;
+        int last_mhz() const { return start_mhz + (count - 1) * step_mhz; }
+    };
+
+    SpectrumPlan()
+        : slots(nullptr), slot_capacity(0), slot_count(0), band_count(0),
+          used_users(0), capacity(0), messages(0), full_slots(0) {}
+    ~SpectrumPlan() { delete[] slots; }
+
+    SpectrumPlan(const SpectrumPlan&) = delete;
+    SpectrumPlan& operator=(const SpectrumPlan&) = delete;
+
+    void build(const NetworkConfig& cfg) {
+        // Bands are validated as disjoint, so ordering them by start orders every slot
+        band_count = 0;
+        for (int b = 0; b < cfg.band_count; ++b) {
+            const NetworkConfig::Band& src = cfg.bands[b];
+            int pos = band_count;
+            while (pos > 0 && bands[pos - 1].start_mhz > src.start_mhz) {
+                bands[pos] = bands[pos - 1];
+                --pos;
+            }
+            bands[pos].start_mhz = src.start_mhz;
+            bands[pos].step_mhz = src.step_mhz;
+            bands[pos].count = src.count;
+            bands[pos].max_users = src.max_users;
+            ++band_count;
+        }
+
+        int total = cfg.getSlotCount();
+        if (total > slot_capacity) {
+            delete[] slots;
+            slots = new Slot[total];
+            slot_capacity = total;
+        }
+        slot_count = 0;
+        used_users = 0;
+        capacity = 0;
+        messages = 0;
+        full_slots = 0;
+        for (int b = 0; b < band_count; ++b) {
+            bands[b].first_slot = slot_count;
+            bands[b].used_users = 0;
+            bands[b].capacity = static_cast<long>(bands[b].count) * bands[b].max_users;
+            bands[b].full_slots = bands[b].max_users <= 0 ? bands[b].count : 0;
+            capacity += bands[b].capacity;
+            full_slots += bands[b].full_slots;
+            for (int k = 0; k < bands[b].count; ++k) {
+                slots[slot_count].frequency_mhz = bands[b].start_mhz + k * bands[b].step_mhz;
+                slots[slot_count].current_users = 0;
+                slots[slot_count].max_users = bands[b].max_users;
+                slots[slot_count].messages = 0;
+                slots[slot_count].band = b;
+                slots[slot_count].utilisation_pct = 0;
+                ++slot_count;
+            }
+        }
+    }
+
+    // Slot index for an exact carrier frequency, or -1
+    int findSlot(int freq_mhz) const {
+        int b = findBand(freq_mhz);
+        if (b < 0) return -1;
+        const BandRange& r = bands[b];
+        int offset = freq_mhz - r.start_mhz;
+        if (offset % r.step_mhz != 0) return -1;
+        int k = offset / r.step_mhz;
+        if (k >= r.count) return -1;
+        return r.first_slot + k;
+    }
+
+    // Applies an occupancy change to a slot and every aggregate above it
+    void adjust(int slot_idx, int users_delta, long messages_delta) {
+        Slot& slot = slots[slot_idx];
+        BandRange& b = bands[slot.band];
+        bool was_full = slot.current_users >= slot.max_users;
+        slot.current_users += users_delta;
+        slot.messages += messages_delta;
+        slot.utilisation_pct = slot.max_users > 0 ? (slot.current_users * 100) / slot.max_users : 0;
+        int full_delta = static_cast<int>(slot.current_users >= slot.max_users) - static_cast<int>(was_full);
+        b.used_users += users_delta;
+        b.full_slots += full_delta;
+        used_users += users_delta;
+        full_slots += full_delta;
+        messages += messages_delta;
+    }
+
+    long getUsedUsers() const { return used_users; }
+    long getCapacity() const { return capacity; }
+    long getMessages() const { return messages; }
+    int getFullSlots() const { return full_slots; }
+
+    // Band holding a slot index (binary search over first_slot)
+    int bandOfSlot(int slot_idx) const {
+        int lo = 0, hi = band_count - 1, found = -1;
+        while (lo <= hi) {
+            int mid = (lo + hi) / 2;
+            if (bands[mid].first_slot <= slot_idx) { found = mid; lo = mid + 1; }
+            else hi = mid - 1;
+        }
+        return found;
+    }
+
+    int getSlotCount() const { return slot_count; }
+    int getBandCount() const { return band_count; }
+    const BandRange& band(int b) const { return bands[b]; }
+    Slot& operator[](int i) { return slots[i]; }
+    const Slot& operator[](int i) const { return slots[i]; }
+
+private:
+    Slot* slots;
+    int slot_capacity;
+    int slot_count;
+    BandRange bands[NetworkConfig::MAX_BANDS];
+    int band_count;
+    long used_users;
+    long capacity;
+    long messages;
+    int full_slots;
+
+    // Last band starting at or below freq
+    int findBand(int freq_mhz) const {
+        int lo = 0, hi = band_count - 1, found = -1;
+        while (lo <= hi) {
+            int mid = (lo + hi) / 2;
+            if (bands[mid].start_mhz <= freq_mhz) { found = mid; lo = mid + 1; }
+            else hi = mid - 1;
+        }
+        return found;
+    }
+};
@@ -0,0 +1,421 @@
+#pragma once
+#include <atomic>
+#include <thread>
+#include "NetworkConfig.h"
+#include "Clock.h"
+
+// Bounded single-producer/single-consumer ring. Lock-free: only the producer
+// advances tail and only the consumer advances head.
+template<typename T>
+class SpscQueue {
+public:
+    SpscQueue() : buf(nullptr), mask(0), head(0), tail(0) {}
+    ~SpscQueue() { delete[] buf; }
+
+    SpscQueue(const SpscQueue&) = delete;
+    SpscQueue& operator=(const SpscQueue&) = delete;
+
+    void init(unsigned long capacity_pow2) {
+        delete[] buf;
+        buf = new T[capacity_pow2];
+        mask = capacity_pow2 - 1;
+        head.store(0, std::memory_order_relaxed);
+        tail.store(0, std::memory_order_relaxed);
+    }
+
+    bool push(const T& value) {
+        unsigned long t = tail.load(std::memory_order_relaxed);
+        if (t - head.load(std::memory_order_acquire) > mask) return false;
+        buf[t & mask] = value;
+        tail.store(t + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool pop(T& value) {
+        unsigned long h = head.load(std::memory_order_relaxed);
+        if (h == tail.load(std::memory_order_acquire)) return false;
+        value = buf[h & mask];
+        head.store(h + 1, std::memory_order_release);
+        return true;
+    }
+
+private:
+    T* buf;
+    unsigned long mask;
+    alignas(64) std::atomic<unsigned long> head;
+    alignas(64) std::atomic<unsigned long> tail;
+};
+
+// Sense-counting spin barrier for a fixed set of worker threads
+class SpinBarrier {
+public:
+    explicit SpinBarrier(int n) : count(0), phase(0), total(n) {}
+
+    void wait() {
+        int current = phase.load(std::memory_order_acquire);
+        if (count.fetch_add(1, std::memory_order_acq_rel) + 1 == total) {
+            count.store(0, std::memory_order_relaxed);
+            phase.fetch_add(1, std::memory_order_release);
+            return;
+        }
+        while (phase.load(std::memory_order_acquire) == current) std::this_thread::yield();
+    }
+
+private:
+    std::atomic<int> count;
+    std::atomic<int> phase;
+    int total;
+};
+
+// 🔥 Network of cells for one generation laid out on a rows x cols grid
+// (8-neighbour adjacency). Cells are light records sized from the generation
+// profile; users carry their serving-cell ID. Cells are partitioned into
+// contiguous ranges of at least a grid row's worth of cells, one worker
+// thread each. Handovers that cross partitions travel through SPSC queues,
+// one per pair of bordering partitions, and are admitted by the owning worker.
+class Topology {
+public:
+    struct Stats {
+        long attempts;        // handovers started from congested cells
+        long intra;           // completed inside one partition
+        long cross;           // completed through a partition queue
+        long bounced;         // refused by the target cell's owner
+        long deferred;        // queue full, retried next round
+        int congested_before;
+        int congested_after;
+        long elapsed_us;
+    };
+
+    static const int MAX_PARTITIONS = 64;
+
+    Topology(int gen, int rows, int cols, int partitions, int congestion_pct = 90)
+        : generation(gen), grid_rows(rows), grid_cols(cols), cell_count(rows * cols),
+          partition_count(partitions), threshold_pct(congestion_pct),
+          cells(nullptr), users(nullptr), user_count(0), user_capacity(0),
+          handovers(nullptr), bounces(nullptr) {
+        if (partition_count < 1) partition_count = 1;
+        if (partition_count > MAX_PARTITIONS) partition_count = MAX_PARTITIONS;
+        if (partition_count > grid_rows) partition_count = grid_rows;   // a partition holds whole rows
+
+        // A cell carries the whole band plan of its generation
+        const NetworkConfig& cfg = NetworkConfig::profile(gen);
+        int capacity = 0;
+        for (int b = 0; b < cfg.band_count; ++b) capacity += cfg.bands[b].count * cfg.bands[b].max_users;
+        for (int s = 0; s < NetworkConfig::MAX_SERVICES; ++s) service_messages[s] = cfg.messagesFor(s);
+
+        cells = new Cell[cell_count];
+        for (int i = 0; i < cell_count; ++i) {
+            cells[i].capacity = capacity;
+            cells[i].load.store(0, std::memory_order_relaxed);
+            cells[i].messages = 0;
+            cells[i].head = -1;
+        }
+
+        // Queues only between partitions whose cells can be grid neighbours:
+        // those holding a cell within one row (+1) of the partition's range
+        int queue_count = 0;
+        for (int p = 0; p < partition_count; ++p) {
+            int lo = firstCell(p) - grid_cols - 1;
+            int hi = firstCell(p + 1) + grid_cols;
+            neighbour_lo[p] = partitionOf(lo < 0 ? 0 : lo);
+            neighbour_hi[p] = partitionOf(hi >= cell_count ? cell_count - 1 : hi);
+            queue_base[p] = queue_count;
+            queue_count += neighbour_hi[p] - neighbour_lo[p] + 1;
+        }
+        handovers = new SpscQueue<Handover>[queue_count];
+        bounces = new SpscQueue<Handover>[queue_count];
+        for (int p = 0; p < partition_count; ++p) {
+            for (int q = neighbour_lo[p]; q <= neighbour_hi[p]; ++q) {
+                if (q == p) continue;
+                handovers[queueIndex(p, q)].init(QUEUE_CAPACITY);
+                bounces[queueIndex(p, q)].init(QUEUE_CAPACITY);
+            }
+        }
+    }
+
+    ~Topology() {
+        delete[] cells;
+        delete[] users;
+        delete[] handovers;
+        delete[] bounces;
+    }
+
+    Topology(const Topology&) = delete;
+    Topology& operator=(const Topology&) = delete;
+
+    void reserveUsers(long n) {
+        if (n <= user_capacity) return;
+        User* grown = new User[n];
+        for (long i = 0; i < user_count; ++i) grown[i] = users[i];
+        delete[] users;
+        users = grown;
+        user_capacity = n;
+    }
+
+    // Attach a user to a cell; returns the user ID or -1 if the cell is full
+    long addUser(int cell, int service_type) {
+        if (cell < 0 || cell >= cell_count) return -1;
+        Cell& c = cells[cell];
+        if (c.load.load(std::memory_order_relaxed) >= c.capacity) return -1;
+        if (user_count >= user_capacity) reserveUsers(user_capacity ? user_capacity * 2 : 1024);
+        long id = user_count++;
+        users[id].service = service_type;
+        users[id].messages = messagesFor(service_type);
+        link(id, cell);
+        return id;
+    }
+
+    // Uniform background load plus a hotspot: hotspot_pct of the users land in
+    // ~1% of the cells, which is what drives congestion and handover.
+    long populate(long n, int hotspot_pct, unsigned long seed) {
+        reserveUsers(user_count + n);
+        int hot_cells = cell_count / 100;
+        if (hot_cells < 1) hot_cells = 1;
+        unsigned long rng = seed ? seed : 0x9e3779b97f4a7c15UL;
+        long added = 0;
+        for (long i = 0; i < n; ++i) {
+            unsigned long r = next(rng);
+            int cell = (static_cast<int>(r % 100) < hotspot_pct)
+                           ? static_cast<int>((r >> 8) % hot_cells) * (cell_count / hot_cells)
+                           : static_cast<int>((r >> 8) % cell_count);
+            int service = 1 + static_cast<int>((r >> 40) % 4);
+            // A full cell spills to the next one, like a device reselecting
+            for (int tries = 0; tries < 8; ++tries) {
+                if (addUser(cell, service) >= 0) { ++added; break; }
+                cell = (cell + 1) % cell_count;
+            }
+        }
+        return added;
+    }
+
+    // Runs `rounds` handover rounds across partition_count worker threads
+    Stats rebalance(int rounds) {
+        Stats total = {};
+        total.congested_before = getCongestedCount();
+        long start = Clock::nowNs();
+
+        Stats per_worker[MAX_PARTITIONS] = {};
+        SpinBarrier barrier(partition_count);
+        std::thread workers[MAX_PARTITIONS];
+        for (int p = 0; p < partition_count; ++p) {
+            workers[p] = std::thread([this, p, rounds, &barrier, &per_worker]() {
+                // Handovers queued this round toward cells owned by other workers;
+                // those cells all sit within one grid row of this partition
+                int span = grid_cols + 1;
+                int* pending = new int[2 * span]();
+                for (int r = 0; r < rounds; ++r) {
+                    for (int i = 0; i < 2 * span; ++i) pending[i] = 0;
+                    offloadCongested(p, pending, per_worker[p]);
+                    barrier.wait();
+                    admitIncoming(p, per_worker[p]);
+                    barrier.wait();
+                    restoreBounced(p);
+                    barrier.wait();
+                }
+                delete[] pending;
+            });
+        }
+        for (int p = 0; p < partition_count; ++p) workers[p].join();
+
+        for (int p = 0; p < partition_count; ++p) {
+            total.attempts += per_worker[p].attempts;
+            total.intra += per_worker[p].intra;
+            total.cross += per_worker[p].cross;
+            total.bounced += per_worker[p].bounced;
+            total.deferred += per_worker[p].deferred;
+        }
+        total.elapsed_us = Clock::elapsedUs(start);
+        total.congested_after = getCongestedCount();
+        return total;
+    }
+
+    int getCongestedCount() const {
+        int congested = 0;
+        for (int i = 0; i < cell_count; ++i)
+            if (isCongested(i)) ++congested;
+        return congested;
+    }
+
+    int getCellCount() const { return cell_count; }
+    int getPartitionCount() const { return partition_count; }
+    long getUserCount() const { return user_count; }
+    int getCellLoad(int cell) const { return cells[cell].load.load(std::memory_order_relaxed); }
+    int getCellCapacity(int cell) const { return cells[cell].capacity; }
+    int getServingCell(long user) const { return users[user].cell; }
+    int getGeneration() const { return generation; }
+
+private:
+    static const unsigned long QUEUE_CAPACITY = 4096;
+
+    struct Cell {
+        int capacity;
+        std::atomic<int> load;  // read by neighbouring partitions as a hint
+        long messages;
+        long head;              // first user on the cell (intrusive list)
+    };
+
+    struct User {
+        int cell;
+        int service;
+        int messages;
+        long prev;
+        long next;
+    };
+
+    struct Handover {
+        long user;
+        int source;
+        int target;
+    };
+
+    int generation;
+    int grid_rows;
+    int grid_cols;
+    int cell_count;
+    int partition_count;
+    int threshold_pct;
+    int service_messages[NetworkConfig::MAX_SERVICES];
+    Cell* cells;
+    User* users;
+    long user_count;
+    long user_capacity;
+    SpscQueue<Handover>* handovers; // [queueIndex(src, dst)]
+    SpscQueue<Handover>* bounces;   // [queueIndex(dst, src)]
+    int neighbour_lo[MAX_PARTITIONS];   // bordering partitions of p: [lo, hi], p included
+    int neighbour_hi[MAX_PARTITIONS];
+    int queue_base[MAX_PARTITIONS];
+
+    int queueIndex(int from, int to) const { return queue_base[from] + to - neighbour_lo[from]; }
+
+    int messagesFor(int service_type) const {
+        if (service_type < 1 || service_type >= NetworkConfig::MAX_SERVICES)
+            service_type = NetworkConfig::MAX_SERVICES - 1;
+        return service_messages[service_type];
+    }
+
+    static unsigned long next(unsigned long& state) {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        return state;
+    }
+
+    int congestionLevel(int cell) const {
+        return static_cast<int>((static_cast<long>(cells[cell].capacity) * threshold_pct) / 100);
+    }
+
+    bool isCongested(int cell) const {
+        return cells[cell].load.load(std::memory_order_relaxed) > congestionLevel(cell);
+    }
+
+    int partitionOf(int cell) const {
+        return static_cast<int>((static_cast<long>(cell) * partition_count) / cell_count);
+    }
+
+    int firstCell(int p) const {
+        return static_cast<int>((static_cast<long>(p) * cell_count + partition_count - 1) / partition_count);
+    }
+
+    void link(long id, int cell) {
+        Cell& c = cells[cell];
+        users[id].cell = cell;
+        users[id].prev = -1;
+        users[id].next = c.head;
+        if (c.head >= 0) users[c.head].prev = id;
+        c.head = id;
+        c.messages += users[id].messages;
+        c.load.store(c.load.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+
+    void unlink(long id) {
+        Cell& c = cells[users[id].cell];
+        if (users[id].prev >= 0) users[users[id].prev].next = users[id].next;
+        else c.head = users[id].next;
+        if (users[id].next >= 0) users[users[id].next].prev = users[id].prev;
+        c.messages -= users[id].messages;
+        c.load.store(c.load.load(std::memory_order_relaxed) - 1, std::memory_order_relaxed);
+    }
+
+    // Slot in a worker's pending[] for a cell outside [first, last), or -1
+    int pendingIndex(int cell, int first, int last) const {
+        int span = grid_cols + 1;
+        if (cell < first) return cell - (first - span);
+        if (cell >= last) return span + (cell - last);
+        return -1;
+    }
+
+    // Least-loaded grid neighbour that stays under the congestion level, or -1.
+    // Remote neighbours count the handovers already queued toward them.
+    int pickTarget(int cell, const int* pending, int first, int last) const {
+        int row = cell / grid_cols, col = cell % grid_cols;
+        int best = -1;
+        int best_load = 0;
+        for (int dr = -1; dr <= 1; ++dr) {
+            for (int dc = -1; dc <= 1; ++dc) {
+                if (dr == 0 && dc == 0) continue;
+                int r = row + dr, c = col + dc;
+                if (r < 0 || r >= grid_rows || c < 0 || c >= grid_cols) continue;
+                int n = r * grid_cols + c;
+                int load = cells[n].load.load(std::memory_order_relaxed);
+                int slot = pendingIndex(n, first, last);
+                if (slot >= 0) load += pending[slot];
+                if (load + 1 > congestionLevel(n)) continue;
+                if (best < 0 || load < best_load) { best = n; best_load = load; }
+            }
+        }
+        return best;
+    }
+
+    // Phase 1: each congested cell hands users to its least-loaded neighbours
+    void offloadCongested(int p, int* pending, Stats& stats) {
+        int first = firstCell(p), last = firstCell(p + 1);
+        for (int cell = first; cell < last; ++cell) {
+            while (isCongested(cell)) {
+                int target = pickTarget(cell, pending, first, last);
+                if (target < 0) break;
+                long id = cells[cell].head;
+                ++stats.attempts;
+                int dst = partitionOf(target);
+                if (dst == p) {
+                    unlink(id);
+                    link(id, target);
+                    ++stats.intra;
+                    continue;
+                }
+                Handover h = {id, cell, target};
+                if (!handovers[queueIndex(p, dst)].push(h)) {
+                    ++stats.deferred;
+                    break;
+                }
+                unlink(id);
+                ++pending[pendingIndex(target, first, last)];
+            }
+        }
+    }
+
+    // Phase 2: the owner of each target cell admits or refuses queued handovers
+    void admitIncoming(int p, Stats& stats) {
+        for (int src = neighbour_lo[p]; src <= neighbour_hi[p]; ++src) {
+            if (src == p) continue;
+            Handover h;
+            while (handovers[queueIndex(src, p)].pop(h)) {
+                if (cells[h.target].load.load(std::memory_order_relaxed) + 1 <= congestionLevel(h.target)) {
+                    link(h.user, h.target);
+                    ++stats.cross;
+                } else {
+                    ++stats.bounced;
+                    bounces[queueIndex(p, src)].push(h); // sized like handovers, cannot overflow
+                }
+            }
+        }
+    }
+
+    // Phase 3: refused users go back to their source cell
+    void restoreBounced(int p) {
+        for (int dst = neighbour_lo[p]; dst <= neighbour_hi[p]; ++dst) {
+            if (dst == p) continue;
+            Handover h;
+            while (bounces[queueIndex(dst, p)].pop(h)) link(h.user, h.source);
+        }
+    }
+};
@@ -0,0 +1,133 @@
+#pragma once
+#include "basicIO.h"
+#include "Clock.h"
+
+// 🔥 Binary trace of engine operations. Every GenerationManager instance gets
+// an id; while recording, its creation, admissions (with the concrete
+// frequency tried and the verdict), removals, frequency queries and
+// destruction are appended as fixed 16-byte records after an 8-byte header.
+// Records are buffered and written 64KB at a time, so an idle recorder costs
+// one branch per operation. TraceReplay.h re-executes a trace.
+class Trace {
+public:
+    enum Op {
+        OP_CREATE = 1,   // gen, arg = core capacity
+        OP_DESTROY,      // gen
+        OP_ADD,          // gen, service (+ carriers, see packService), result = AdmitResult, arg = frequency
+        OP_REMOVE,       // gen, arg = user id
+        OP_QUERY,        // gen, result = users found, arg = frequency
+        OP_PREEMPT,      // gen, arg = 1 (QoS preemption on) / 0 (off)
+        OP_RESET         // gen: every user dropped, core cleared
+    };
+
+    struct Record {
+        unsigned int dt_us;      // time since the previous record (saturating)
+        unsigned char op;
+        unsigned char gen;
+        unsigned char service;
+        unsigned char result;
+        unsigned int manager;    // engine instance id
+        int arg;
+    };
+    static_assert(sizeof(Record) == 16, "trace record layout");
+
+    static const unsigned int MAGIC = 0x52545343;  // "CSTR"
+    static const unsigned int VERSION = 1;
+    static const int HEADER_BYTES = 8;
+
+    static bool start(const char* path) {
+        State& s = state();
+        stop();
+        s.fd = syscall3(2, (long)path, 1 | 64 | 512, 0644); // SYS_OPEN, O_WRONLY | O_CREAT | O_TRUNC
+        if (s.fd < 0) return false;
+        unsigned int header[2] = {MAGIC, VERSION};
+        syscall3(1, s.fd, (long)header, sizeof(header));
+        s.last_ns = Clock::nowNs();
+        s.len = 0;
+        return true;
+    }
+
+    static void stop() {
+        State& s = state();
+        if (s.fd < 0) return;
+        flush();
+        syscall3(3, s.fd, 0, 0); // SYS_CLOSE
+        s.fd = -1;
+    }
+
+    static bool recording() { return state().fd >= 0; }
+
+    // In a forked child (WhatIf.h): stop recording without writing, so
+    // neither the parent's buffered records nor the child's reach the file
+    static void abandon() {
+        State& s = state();
+        s.fd = -1;
+        s.len = 0;
+    }
+
+    // Engine instance ids are handed out whether or not a trace is active
+    static unsigned int attach(int gen, long core_capacity) {
+        unsigned int id = state().next_id++;
+        if (core_capacity > 0x7fffffffL) core_capacity = 0x7fffffffL;
+        if (recording()) log(OP_CREATE, id, gen, 0, 0, static_cast<int>(core_capacity));
+        return id;
+    }
+
+    static void detach(unsigned int id, int gen) {
+        if (recording()) log(OP_DESTROY, id, gen, 0, 0, 0);
+    }
+
+    // OP_ADD service byte: service type in the low nibble, requested component
+    // carriers - 1 in the high nibble (0 in version-1 traces = one carrier)
+    static int packService(int service, int carriers) {
+        int extra = carriers < 1 ? 0 : (carriers > 16 ? 15 : carriers - 1);
+        return (service & 15) | (extra << 4);
+    }
+    static int serviceOf(int packed) { return packed & 15; }
+    static int carriersOf(int packed) { return (packed >> 4) + 1; }
+
+    static void log(Op op, unsigned int manager, int gen, int service, int result, int arg) {
+        State& s = state();
+        long now = Clock::nowNs();
+        long dt = (now - s.last_ns) / 1000;
+        s.last_ns = now;
+        Record& r = s.buf[s.len];
+        r.dt_us = dt > 0xffffffffL ? 0xffffffffU : static_cast<unsigned int>(dt);
+        r.op = static_cast<unsigned char>(op);
+        r.gen = static_cast<unsigned char>(gen);
+        r.service = static_cast<unsigned char>(service);
+        r.result = static_cast<unsigned char>(result > 255 ? 255 : result);
+        r.manager = manager;
+        r.arg = arg;
+        if (++s.len == BUFFER_RECORDS) flush();
+    }
+
+private:
+    static const int BUFFER_RECORDS = 4096;
+
+    struct State {
+        long fd;
+        long last_ns;
+        unsigned int next_id;
+        int len;
+        Record buf[BUFFER_RECORDS];
+    };
+
+    static State& state() {
+        static State s = {-1, 0, 1, 0, {}};
+        return s;
+    }
+
+    static void flush() {
+        State& s = state();
+        const char* p = reinterpret_cast<const char*>(s.buf);
+        long left = static_cast<long>(s.len) * sizeof(Record);
+        while (left > 0) {
+            long n = syscall3(1, s.fd, (long)p, left); // SYS_WRITE
+            if (n <= 0) break;
+            p += n;
+            left -= n;
+        }
+        s.len = 0;
+    }
+};
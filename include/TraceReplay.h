@@ -0,0 +1,148 @@
+#pragma once
+#include "Trace.h"
+#include "GenerationManager.h"
+#include "CellularCore.h"
+#include "Clock.h"
+
+// 🔥 Re-executes a recorded trace against fresh engine instances with no
+// console output. run() goes at full speed (recorded timestamps ignored);
+// step() / nextTimeUs() let a caller pace the replay itself, e.g. the watch
+// dashboard. Each admission and query is compared with the recorded verdict,
+// so a replay is both a regression benchmark and a determinism check.
+class TraceReplay {
+public:
+    struct Result {
+        bool valid;        // header recognised
+        long ops;          // add/remove/query records executed
+        long adds;
+        long removes;
+        long queries;
+        long mismatches;   // verdicts that differ from the recording
+        long skipped;      // records for engines whose creation was not recorded
+        long elapsed_ns;   // operation time, engine setup excluded (run() only)
+    };
+
+    TraceReplay(const char* data, long bytes)
+        : base(data + Trace::HEADER_BYTES), count(0), next(0), time_us(0), setup_ns(0) {
+        res = Result{false, 0, 0, 0, 0, 0, 0, 0};
+        for (int i = 0; i < MAX_LIVE; ++i) engines[i] = Engine{0, nullptr, nullptr};
+        const unsigned int* header = reinterpret_cast<const unsigned int*>(data);
+        if (bytes < Trace::HEADER_BYTES || header[0] != Trace::MAGIC || header[1] != Trace::VERSION) return;
+        res.valid = true;
+        count = (bytes - Trace::HEADER_BYTES) / static_cast<long>(sizeof(Trace::Record));
+    }
+
+    ~TraceReplay() {
+        for (int i = 0; i < MAX_LIVE; ++i) release(engines[i]);
+    }
+
+    TraceReplay(const TraceReplay&) = delete;
+    TraceReplay& operator=(const TraceReplay&) = delete;
+
+    static Result run(const char* data, long bytes) {
+        TraceReplay replay(data, bytes);
+        long start = Clock::nowNs();
+        while (!replay.done()) replay.step();
+        replay.res.elapsed_ns = Clock::nowNs() - start - replay.setup_ns;
+        return replay.res;
+    }
+
+    bool isValid() const { return res.valid; }
+    bool done() const { return next >= count; }
+    const Result& result() const { return res; }
+    long getRecordCount() const { return count; }
+    long getPosition() const { return next; }
+
+    // Recorded time of the next record, in us since the trace started
+    long nextTimeUs() const {
+        if (done()) return time_us;
+        Trace::Record r;
+        copyRecord(base + next * sizeof(Trace::Record), r);
+        return time_us + r.dt_us;
+    }
+
+    void step() {
+        Trace::Record r;
+        copyRecord(base + next++ * sizeof(Trace::Record), r);
+        time_us += r.dt_us;
+        Engine& e = engines[r.manager % MAX_LIVE];
+
+        if (r.op == Trace::OP_CREATE) {
+            if (e.manager) { ++res.skipped; return; }   // slot taken by a live engine
+            if (r.gen < NetworkConfig::MIN_GEN || r.gen > NetworkConfig::MAX_GEN) { ++res.skipped; return; }
+            long setup = Clock::nowNs();
+            e.id = r.manager;
+            e.core = new CellularCore<long>(r.arg);
+            e.manager = new GenerationManager(r.gen, e.core);
+            setup_ns += Clock::nowNs() - setup;
+            return;
+        }
+        if (!e.manager || e.id != r.manager) { ++res.skipped; return; }
+
+        if (r.op == Trace::OP_ADD) {
+            if (e.manager->tryAddUser(Trace::serviceOf(r.service), r.arg, Trace::carriersOf(r.service)) != r.result)
+                ++res.mismatches;
+            ++res.adds;
+        } else if (r.op == Trace::OP_REMOVE) {
+            e.manager->removeUser(r.arg);
+            ++res.removes;
+        } else if (r.op == Trace::OP_QUERY) {
+            static UserDevice found[100];
+            int n = 0;
+            e.manager->getUsersOnFrequency(r.arg, found, n);
+            if ((n > 255 ? 255 : n) != r.result) ++res.mismatches;
+            ++res.queries;
+        } else if (r.op == Trace::OP_RESET) {
+            e.manager->reset();
+        } else if (r.op == Trace::OP_PREEMPT) {
+            e.manager->setPreemption(r.arg != 0);
+        } else if (r.op == Trace::OP_DESTROY) {
+            long setup = Clock::nowNs();
+            release(e);
+            setup_ns += Clock::nowNs() - setup;
+            return;
+        } else {
+            ++res.skipped;
+            return;
+        }
+        ++res.ops;
+    }
+
+    // Live engines in creation-slot order; returns how many were written
+    int getEngines(const GenerationManager* out[], int max) const {
+        int n = 0;
+        for (int i = 0; i < MAX_LIVE && n < max; ++i)
+            if (engines[i].manager) out[n++] = engines[i].manager;
+        return n;
+    }
+
+private:
+    static const int MAX_LIVE = 256;
+
+    struct Engine {
+        unsigned int id;
+        CellularCore<long>* core;
+        GenerationManager* manager;
+    };
+
+    const char* base;
+    long count;
+    long next;
+    long time_us;
+    long setup_ns;   // engine construction/teardown, excluded from elapsed_ns
+    Result res;
+    Engine engines[MAX_LIVE];
+
+    // Records in the file are not guaranteed to be aligned
+    static void copyRecord(const char* src, Trace::Record& r) {
+        char* dst = reinterpret_cast<char*>(&r);
+        for (unsigned int k = 0; k < sizeof(Trace::Record); ++k) dst[k] = src[k];
+    }
+
+    static void release(Engine& e) {
+        delete e.manager;
+        delete e.core;
+        e.manager = nullptr;
+        e.core = nullptr;
+    }
+};
@@ -6,9 +6,11 @@ private:
     int frequency_mhz;
     int messages;
     int service_type; // 1=Voice, 2=SMS, 3=Data, 4=Voice+Data
+    int carrier_base;            // 🔥 component carriers: bit k = slot carrier_base + k
+    unsigned long carrier_mask;  // (frequency_mhz is the primary carrier)
 
 public:
-    UserDevice() : frequency_mhz(0), messages(0), service_type(0) {
+    UserDevice() : frequency_mhz(0), messages(0), service_type(0), carrier_base(0), carrier_mask(0) {
         user_id[0] = '\0';
     }
 
@@ -20,11 +22,19 @@ public:
     void setFrequency(int freq) { frequency_mhz = freq; }
     void setMessages(int msg) { messages = msg; }
     void setServiceType(int service) { service_type = service; } // 🔥 ADDED
+    void setCarriers(int base_slot, unsigned long mask) { carrier_base = base_slot; carrier_mask = mask; }
 
     const char* getID() const { return user_id; }
     int getFrequency() const { return frequency_mhz; }
     int getMessages() const { return messages; }
     int getServiceType() const { return service_type; } // 🔥 ADDED
+    int getCarrierBase() const { return carrier_base; }
+    unsigned long getCarrierMask() const { return carrier_mask; }
+    int getCarrierCount() const { return __builtin_popcountl(carrier_mask); }
+    bool holdsSlot(int slot_idx) const {
+        int k = slot_idx - carrier_base;
+        return k >= 0 && k < 64 && ((carrier_mask >> k) & 1);
+    }
 
     void serialize(char* out) const {
         if (!out) return;
@@ -0,0 +1,59 @@
+#pragma once
+#include "basicIO.h"
+#include "Clock.h"
+#include "Trace.h"
+
+// 🔥 What-if forks of the whole simulator. fork(2) hands the child a
+// copy-on-write view of every page: all GenerationManagers, their cores and
+// the rest of the engine state stay shared with the live process until
+// written, and the kernel copies only the 4 KB pages the what-if run
+// modifies. The fork itself is a page-table copy, so it costs the same
+// whether the run then adds five users or five thousand. The parent waits
+// for the child, and everything the child changed vanishes when it exits.
+//
+// The body runs in the child and must stay single-threaded (the child has
+// only the forking thread). It must not write files the live process owns:
+// the trace is detached in the child for that reason.
+class WhatIf {
+public:
+    struct Result {
+        bool forked;
+        int exit_code;      // body's return value (-1 if the child was killed)
+        long fork_ns;       // fork syscall, as seen by the parent
+        long total_ns;      // until the child exited
+    };
+
+    template<typename Body>
+    static Result run(Body body) {
+        Result r = {false, -1, 0, 0};
+        long start = Clock::nowNs();
+        long pid = syscall3(SYS_FORK, 0, 0, 0);
+        if (pid == 0) {
+            syscall3(SYS_PRCTL, PR_SET_PDEATH_SIGNAL, SIG_KILL, 0);   // never outlive the live process
+            Trace::abandon();
+            int rc = 1;
+            try {
+                rc = body();
+            } catch (...) {
+            }
+            syscall3(SYS_EXIT_GROUP, rc, 0, 0);   // no destructors: the parent still owns the engines
+        }
+        r.fork_ns = Clock::nowNs() - start;
+        if (pid < 0) return r;
+        r.forked = true;
+        int status = 0;
+        while (syscall6(SYS_WAIT4, pid, (long)&status, 0, 0, 0, 0) == -E_INTR) {}
+        if ((status & 0x7f) == 0) r.exit_code = (status >> 8) & 0xff;
+        r.total_ns = Clock::nowNs() - start;
+        return r;
+    }
+
+private:
+    static const long SYS_FORK = 57;
+    static const long SYS_WAIT4 = 61;
+    static const long SYS_PRCTL = 157;
+    static const long SYS_EXIT_GROUP = 231;
+    static const long PR_SET_PDEATH_SIGNAL = 1;
+    static const long SIG_KILL = 9;
+    static const long E_INTR = 4;
+};
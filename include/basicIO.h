@@ -3,6 +3,7 @@
 #ifndef BASIC_IO_H
 #define BASIC_IO_H
 extern "C" long syscall3(long number, long arg1, long arg2, long arg3);
+extern "C" long syscall6(long number, long arg1, long arg2, long arg3, long arg4, long arg5, long arg6);
 
 
 class basicIO {
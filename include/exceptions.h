@@ -28,3 +28,20 @@ class InvalidSpectrumException : public CellularException {
 public:
     InvalidSpectrumException() : CellularException("Spectrum exceeds hardware limits") {}
 };
+
+class InvalidConfigException : public CellularException {
+public:
+    // line 0 = file-level problem (too large, or a generation failed validation)
+    InvalidConfigException(int line) : CellularException("Invalid generation config") {
+        if (line <= 0) return;
+        const char* suffix = " at line ";
+        int i = 0;
+        while (message[i]) ++i;
+        for (int k = 0; suffix[k]; ++k) message[i++] = suffix[k];
+        char digits[12];
+        int count = 0;
+        do { digits[count++] = '0' + (line % 10); line /= 10; } while (line > 0);
+        while (count > 0) message[i++] = digits[--count];
+        message[i] = '\0';
+    }
+};
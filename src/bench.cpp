@@ -0,0 +1,507 @@
+#include "../include/basicIO.h"
+#include "../include/GenerationManager.h"
+#include "../include/CellularCore.h"
+#include "../include/InputParser.h"
+#include "../include/OutBuffer.h"
+#include "../include/Clock.h"
+#include "../include/Scheduler.h"
+#include "../include/CapacityModel.h"
+#include "../include/MimoGrouping.h"
+#include "../include/CoreWorkers.h"
+#include "../include/SignallingStorm.h"
+#include "../include/Coverage.h"
+#include "../include/WhatIf.h"
+
+// Benchmark driver for the engine hot paths. Every case runs at 1K, 100K and
+// 10M users (or up to the limit given on the command line) and the results
+// are written as JSON for regression tracking between releases:
+//
+//   cellsim-bench [results.json] [max_users]
+//
+// GenerationManager and CellularCore hold at most 10,000 users each, so the
+// add/remove/register cases recycle the engine when it fills up and report
+// the resident population next to the operation count.
+
+#define SYS_WRITE 1
+#define SYS_OPEN 2
+#define SYS_CLOSE 3
+#define SYS_DUP 32
+#define SYS_DUP2 33
+#define SYS_UNLINK 87
+#define O_WRONLY 1
+#define O_CREAT 64
+#define O_TRUNC 512
+
+static const long SIZES[] = {1000, 100000, 10000000};
+static const int SIZE_COUNT = 3;
+static const int BENCH_GEN = 7;          // 5G: largest default band plan
+static const long QUERY_COUNT = 10000;   // fixed query batch per population size
+static const int SCHED_USERS = 10000;    // users per cell in the scheduler case
+static const long SCHED_TTIS = 10000;    // 10 s of simulated air time
+
+static char json_storage[1 << 16];
+static OutBuffer json(json_storage, sizeof(json_storage));
+static int result_count = 0;
+
+struct Rng {
+    unsigned long state;
+    explicit Rng(unsigned long seed) : state(seed) {}
+    unsigned long next() {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        return state;
+    }
+};
+
+static void record(const char* name, long users, long ops, long resident, long total_ns) {
+    double ns_per_op = ops > 0 ? static_cast<double>(total_ns) / ops : 0.0;
+    double ops_per_sec = total_ns > 0 ? ops * 1e9 / total_ns : 0.0;
+    if (result_count++ > 0) json.put(",\n");
+    json.put("    {\"case\": \"").put(name)
+        .put("\", \"users\": ").putInt(users)
+        .put(", \"ops\": ").putInt(ops)
+        .put(", \"resident_users\": ").putInt(resident)
+        .put(", \"total_ns\": ").putInt(total_ns)
+        .put(", \"ns_per_op\": ").putFixed(ns_per_op, 2)
+        .put(", \"ops_per_sec\": ").putInt(static_cast<long>(ops_per_sec))
+        .put("}");
+
+    io.errorstring(name);
+    io.errorstring(" users=");
+    io.errorint(static_cast<int>(users));
+    io.errorstring(" ns/op=");
+    io.errorint(static_cast<int>(ns_per_op));
+    io.errorstring("\n");
+}
+
+// addUser/removeUser: fill the manager through the quiet admission path, then
+// drain it by removing random user IDs (the shifting cost of removal included)
+static void benchAddRemove(long users) {
+    CellularCore<long> core(1L << 60);
+    GenerationManager manager(BENCH_GEN, &core);
+    Rng rng(users);
+    int slots = manager.getSlotCount();
+    long add_ns = 0, remove_ns = 0, adds = 0, removes = 0, peak = 0;
+    int next_slot = 0;
+
+    while (adds < users) {
+        long start = Clock::nowNs();
+        while (adds < users) {
+            int freq = manager.getSlotFrequency(next_slot);
+            next_slot = (next_slot + 1) % slots;
+            if (manager.tryAddUser(1 + static_cast<int>(adds % 4), freq) != GenerationManager::ADMIT_OK) break;
+            ++adds;
+        }
+        add_ns += Clock::nowNs() - start;
+        if (manager.getUserCount() > peak) peak = manager.getUserCount();
+
+        start = Clock::nowNs();
+        while (manager.getUserCount() > 0 && removes < users) {
+            manager.removeUser(1 + static_cast<int>(rng.next() % manager.getUserCount()));
+            ++removes;
+        }
+        remove_ns += Clock::nowNs() - start;
+        while (manager.getUserCount() > 0) manager.removeUser(manager.getUserCount());
+        core.reset();
+    }
+    record("GenerationManager::addUser", users, adds, peak, add_ns);
+    record("GenerationManager::removeUser", users, removes, peak, remove_ns);
+}
+
+// getUsersOnFrequency: fixed batch of queries against a population of `users`
+static void benchQuery(long users) {
+    CellularCore<long> core(1L << 60);
+    GenerationManager manager(BENCH_GEN, &core);
+    int slots = manager.getSlotCount();
+    for (long i = 0; i < users; ++i) {
+        if (manager.tryAddUser(1 + static_cast<int>(i % 4), manager.getSlotFrequency(i % slots)) != GenerationManager::ADMIT_OK)
+            break;
+    }
+    static UserDevice out[100];
+    long found = 0;
+    long start = Clock::nowNs();
+    for (long q = 0; q < QUERY_COUNT; ++q) {
+        int count = 0;
+        manager.getUsersOnFrequency(manager.getSlotFrequency(q % slots), out, count);
+        found += count;
+    }
+    long elapsed = Clock::nowNs() - start;
+    (void)found;
+    record("GenerationManager::getUsersOnFrequency", users, QUERY_COUNT, manager.getUserCount(), elapsed);
+}
+
+// Carrier aggregation on 4G+: three-carrier admissions (atomic multi-slot
+// reservation), then pairwise carrier queries answered by bitset intersection
+static void benchAggregation(long users) {
+    CellularCore<long> core(1L << 60);
+    GenerationManager manager(6, &core);
+    int slots = manager.getSlotCount();
+    long adds = 0, peak = 0, add_ns = 0;
+    while (adds < users) {
+        long start = Clock::nowNs();
+        while (adds < users && manager.tryAddUser(3, manager.getSlotFrequency(adds % slots), 3) ==
+                                   GenerationManager::ADMIT_OK)
+            ++adds;
+        add_ns += Clock::nowNs() - start;
+        if (manager.getUserCount() == 0) break;   // nothing fits at all
+        if (manager.getUserCount() > peak) peak = manager.getUserCount();
+        if (adds < users) {
+            while (manager.getUserCount() > 0) manager.removeUser(manager.getUserCount());
+            core.reset();
+        }
+    }
+    volatile long both = 0;   // keeps the query loop from being folded away
+    long start = Clock::nowNs();
+    for (long q = 0; q < QUERY_COUNT; ++q)
+        both = both + manager.countUsersOnBoth(manager.getSlotFrequency(q % slots),
+                                               manager.getSlotFrequency((q + 1) % slots));
+    long query_ns = Clock::nowNs() - start;
+    record("GenerationManager::addUser 3CC", users, adds, peak, add_ns);
+    record("GenerationManager::countUsersOnBoth", users, QUERY_COUNT, manager.getUserCount(), query_ns);
+}
+
+// QoS preemption: every 5G slot filled with data users, then voice arrivals
+// each evict one; one op = one preempting admission
+static void benchPreemption() {
+    CellularCore<long> core(1L << 60);
+    GenerationManager manager(BENCH_GEN, &core);
+    int freq = 0;
+    while (manager.tryAddUserAuto(3, freq) == GenerationManager::ADMIT_OK) {}
+    long filled = manager.getUserCount();
+    manager.setPreemption(true);
+    int slots = manager.getSlotCount();
+    long ops = 0;
+    long start = Clock::nowNs();
+    while (manager.tryAddUser(1, manager.getSlotFrequency(ops % slots)) == GenerationManager::ADMIT_OK) ++ops;
+    long elapsed = Clock::nowNs() - start;
+    record("GenerationManager::addUser preempt", filled, ops, manager.getUserCount(), elapsed);
+}
+
+// Engine startup: build and tear down a core plus the manager of every
+// generation, and reset a filled one; one op = one engine
+static void benchStartup() {
+    const int ROUNDS = 1000;
+    long start = Clock::nowNs();
+    for (int r = 0; r < ROUNDS; ++r) {
+        for (int gen = NetworkConfig::MIN_GEN; gen <= NetworkConfig::MAX_GEN; ++gen) {
+            CellularCore<long> core(100);
+            GenerationManager manager(gen, &core);
+        }
+    }
+    long elapsed = Clock::nowNs() - start;
+    long engines = ROUNDS * static_cast<long>(NetworkConfig::MAX_GEN - NetworkConfig::MIN_GEN + 1);
+    record("GenerationManager startup", 0, engines, 0, elapsed);
+
+    CellularCore<long> core(1L << 60);
+    GenerationManager manager(BENCH_GEN, &core);
+    int freq = 0;
+    long resident = 0;
+    long reset_ns = 0;
+    for (int r = 0; r < ROUNDS; ++r) {
+        for (int k = 0; k < 100 && manager.tryAddUserAuto(3, freq) == GenerationManager::ADMIT_OK; ++k) {}
+        resident = manager.getUserCount();
+        long t0 = Clock::nowNs();
+        manager.reset();
+        reset_ns += Clock::nowNs() - t0;
+    }
+    record("GenerationManager::reset", resident, ROUNDS, resident, reset_ns);
+}
+
+// What-if forks: every generation's engine holding up to 5,000 users, then
+// copy-on-write forks of the process that either exit at once (the fork
+// itself) or add 5,000 5G users first (fork plus the pages the change
+// copies); one op = one fork, waited for
+static void benchWhatIf() {
+    const int ROUNDS = 50;
+    const int GENS = NetworkConfig::MAX_GEN - NetworkConfig::MIN_GEN + 1;
+    CellularCore<long>* cores[GENS];
+    GenerationManager* managers[GENS];
+    long resident = 0;
+    for (int g = 0; g < GENS; ++g) {
+        cores[g] = new CellularCore<long>(1L << 60);
+        managers[g] = new GenerationManager(NetworkConfig::MIN_GEN + g, cores[g]);
+        int freq = 0;
+        for (int k = 0; k < 5000 && managers[g]->tryAddUserAuto(3, freq) == GenerationManager::ADMIT_OK; ++k) {}
+        resident += managers[g]->getUserCount();
+    }
+    GenerationManager& target = *managers[BENCH_GEN - NetworkConfig::MIN_GEN];
+
+    long fork_ns = 0;
+    for (int r = 0; r < ROUNDS; ++r) fork_ns += WhatIf::run([]() { return 0; }).total_ns;
+    record("WhatIf::run fork", resident, ROUNDS, resident, fork_ns);
+
+    long change_ns = 0;
+    for (int r = 0; r < ROUNDS; ++r) {
+        change_ns += WhatIf::run([&target]() {
+            int freq = 0;
+            for (int k = 0; k < 5000; ++k) target.tryAddUserAuto(1, freq);
+            return 0;
+        }).total_ns;
+    }
+    record("WhatIf::run +5000 users", resident, ROUNDS, resident, change_ns);
+
+    for (int g = 0; g < GENS; ++g) {
+        delete managers[g];
+        delete cores[g];
+    }
+}
+
+// Work-stealing message processing: the full 5G load (Max Users at the
+// profile's messages per user) on one worker per hardware thread, with no
+// per-message CPU, so the figure is pure queue and steal overhead; one op =
+// one message
+static void benchCoreWorkers() {
+    CellularCore<long> core(100);
+    GenerationManager manager(BENCH_GEN, &core);
+    int threads = static_cast<int>(std::thread::hardware_concurrency());
+    CoreWorkers pool(threads > 0 ? threads : 1, 0);
+    long jobs = pool.loadFull(manager);
+    CoreWorkers::Stats s = pool.run(20);
+    record("CoreWorkers::run", jobs, s.messages, jobs, s.elapsed_ns);
+}
+
+// Signalling storm: every device re-registers within 1 s against a 5G core
+// behind admission backoff; one op = one registration attempt
+static void benchStorm(long users) {
+    SignallingStorm storm(BENCH_GEN, SignallingStorm::defaults(users));
+    SignallingStorm::Result r =
+        storm.run(OverloadControl::defaults(OverloadControl::POLICY_BACKOFF, storm.getRegistrationsPerSec()));
+    record("SignallingStorm::run backoff", users, r.attempts, r.max_queue, r.wall_ns);
+}
+
+// Nearest-tower assignment over 10K 5G sites (500 m apart), one worker per
+// hardware thread, then one incremental move round (50 m steps); one op = one user
+static void benchCoverage(long users) {
+    int threads = static_cast<int>(std::thread::hardware_concurrency());
+    if (threads < 1) threads = 1;
+    Coverage coverage(BENCH_GEN, 10000, 500.0f);
+    coverage.populate(users, 30, threads);
+    long start = Clock::nowNs();
+    coverage.assignAll(threads);
+    long assign_ns = Clock::nowNs() - start;
+    start = Clock::nowNs();
+    coverage.moveAll(50.0f, threads, 1);
+    long move_ns = Clock::nowNs() - start;
+    record("Coverage::assignAll", users, users, users, assign_ns);
+    record("Coverage::moveAll", users, users, users, move_ns);
+}
+
+// MU-MIMO grouping of one full 5G slot (480 users, 64 antennas, 16 layers);
+// one op = one user placed in a group
+static void benchMimo() {
+    static const int SLOT_USERS = 480;
+    MuMimoGrouper grouper(16, SLOT_USERS);
+    for (int i = 0; i < SLOT_USERS; ++i) grouper.addUser(static_cast<unsigned long>(i + 1));
+    static const int ROUNDS = 20;
+    long start = Clock::nowNs();
+    for (int r = 0; r < ROUNDS; ++r) grouper.group();
+    long elapsed = Clock::nowNs() - start;
+    record("MuMimoGrouper::group", SLOT_USERS, static_cast<long>(ROUNDS) * SLOT_USERS, SLOT_USERS, elapsed);
+}
+
+// CellularCore::registerUser: the core is reset whenever its ID table fills
+static void benchRegister(long users) {
+    static CellularCore<long> core(1L << 60); // static: keeps the ID copies observable
+    core.reset();
+    char id[16] = "U";
+    long start = Clock::nowNs();
+    for (long i = 0; i < users; ++i) {
+        long v = i;
+        int len = 1;
+        char digits[12];
+        int count = 0;
+        do { digits[count++] = '0' + (v % 10); v /= 10; } while (v > 0);
+        while (count > 0) id[len++] = digits[--count];
+        id[len] = '\0';
+        if (!core.registerUser(id, 10)) {
+            core.reset();
+            core.registerUser(id, 10);
+        }
+    }
+    long elapsed = Clock::nowNs() - start;
+    record("CellularCore::registerUser", users, users, users < 10000 ? users : 10000, elapsed);
+}
+
+// runFileMode parser over an in-memory input.txt with `users` records for the
+// selected generation plus comments and other generations' lines
+static void benchParser(long users) {
+    long cap = users * 16 + 4096;
+    char* buf = new char[cap];
+    OutBuffer text(buf, cap);
+    text.put("# generated benchmark input\n");
+    Rng rng(users + 1);
+    for (long i = 0; i < users; ++i) {
+        if (i % 64 == 0) text.put("# block\n2 1 1800\n");
+        text.putInt(BENCH_GEN).put(' ').putInt(1 + static_cast<long>(rng.next() % 4)).put(' ')
+            .putInt(1800 + 1000 * static_cast<long>(rng.next() % 11)).put('\n');
+    }
+    long checksum = 0;
+    long start = Clock::nowNs();
+    long records = InputParser::forEachRecord(text.data(), text.size(), BENCH_GEN,
+                                              [&](int service, int freq, int carriers) {
+                                                  checksum += service + freq + carriers;
+                                              });
+    long elapsed = Clock::nowNs() - start;
+    (void)checksum;
+    delete[] buf;
+    record("runFileMode parser", users, records, users, elapsed);
+}
+
+// basicIO output: one "Users on frequency" line per user, sent to /dev/null
+static void benchOutput(long users) {
+    long saved = syscall3(SYS_DUP, 1, 0, 0);
+    long null_fd = syscall3(SYS_OPEN, (long)"/dev/null", O_WRONLY, 0);
+    if (saved < 0 || null_fd < 0) return;
+    syscall3(SYS_DUP2, null_fd, 1, 0);
+    long start = Clock::nowNs();
+    for (long i = 0; i < users; ++i) {
+        io.outputstring("  ");
+        io.outputstring("U");
+        io.outputint(static_cast<int>(i));
+        io.outputstring(" | ");
+        io.outputint(10);
+        io.outputstring(" msgs | ");
+        io.outputstring("Voice");
+        io.terminate();
+    }
+    long elapsed = Clock::nowNs() - start;
+    syscall3(SYS_DUP2, saved, 1, 0);
+    syscall3(SYS_CLOSE, saved, 0, 0);
+    syscall3(SYS_CLOSE, null_fd, 0, 0);
+    record("basicIO output", users, users, users, elapsed);
+}
+
+// Activates `text` as the generation config through a scratch file; an
+// empty text restores the built-in profiles
+static void useConfig(const char* text) {
+    const char* path = "/tmp/cellsim-bench.cfg";
+    long fd = syscall3(SYS_OPEN, (long)path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) return;
+    long len = 0;
+    while (text[len]) ++len;
+    syscall3(SYS_WRITE, fd, (long)text, len);
+    syscall3(SYS_CLOSE, fd, 0, 0);
+    NetworkConfig::loadFile(path);
+    syscall3(SYS_UNLINK, (long)path, 0, 0);
+}
+
+// SINR capacity model on 5G (Shannon mapping): the SoA prefetch kernels an
+// engine runs a block at a time (series SINR draws, then efficiency), and
+// admissions through GenerationManager, which consume those efficiencies;
+// the engine is drained and reset whenever demand fills every carrier
+static void benchCapacity(long users) {
+    const NetworkConfig& cfg = NetworkConfig::profile(BENCH_GEN);
+    float* sinr = new float[users];
+    float* eff = new float[users];
+    long start = Clock::nowNs();
+    CapacityModel::drawSinrSeries(sinr, users, 42, static_cast<float>(cfg.sinr_mean_db),
+                                  static_cast<float>(cfg.sinr_spread_db));
+    CapacityModel::efficiency(sinr, eff, users, NetworkConfig::CAPACITY_SHANNON);
+    long prefetch_ns = Clock::nowNs() - start;
+    delete[] sinr;
+    delete[] eff;
+    record("CapacityModel prefetch", users, users, users, prefetch_ns);
+
+    useConfig("gen 7\ncapacity shannon\n");
+    {
+        CellularCore<long> core(1L << 60);
+        GenerationManager manager(BENCH_GEN, &core);
+        int slots = manager.getSlotCount();
+        long attempts = 0, admitted = 0, peak = 0, add_ns = 0;
+        while (attempts < users) {
+            start = Clock::nowNs();
+            int misses = 0;
+            while (attempts < users && misses < slots) {
+                int freq = manager.getSlotFrequency(attempts % slots);
+                if (manager.tryAddUser(1 + static_cast<int>(attempts % 4), freq) == GenerationManager::ADMIT_OK) {
+                    ++admitted;
+                    misses = 0;
+                } else {
+                    ++misses;
+                }
+                ++attempts;
+            }
+            add_ns += Clock::nowNs() - start;
+            if (manager.getUserCount() > peak) peak = manager.getUserCount();
+            manager.reset();
+        }
+        record("GenerationManager::addUser shannon", users, attempts, peak, add_ns);
+    }
+    useConfig("");
+}
+
+// TtiScheduler::tick: one 5G cell (273 RBs) with SCHED_USERS users; one op
+// is one 1 ms TTI, so the real-time factor is 1e6 / ns_per_op
+static void benchScheduler(TtiScheduler::Policy policy, const char* name) {
+    TtiScheduler sched(TtiScheduler::resourceBlocksFor(BENCH_GEN), SCHED_USERS);
+    Rng rng(SCHED_USERS);
+    for (int i = 0; i < SCHED_USERS; ++i) {
+        float efficiency = 0.15f + 5.35f * static_cast<float>(rng.next() % 1000) / 1000.0f;
+        sched.addUser(efficiency * TtiScheduler::RB_BANDWIDTH_KHZ, static_cast<unsigned int>(rng.next()));
+    }
+    long start = Clock::nowNs();
+    sched.run(policy, SCHED_TTIS);
+    long elapsed = Clock::nowNs() - start;
+    record(name, SCHED_USERS, SCHED_TTIS, SCHED_USERS, elapsed);
+    io.errorstring("  real-time factor x");
+    io.errorint(static_cast<int>(SCHED_TTIS * TtiScheduler::TTI_US * 1000L / (elapsed > 0 ? elapsed : 1)));
+    io.errorstring("\n");
+}
+
+static long parseLong(const char* s) {
+    long v = 0;
+    while (*s >= '0' && *s <= '9') v = v * 10 + (*s++ - '0');
+    return v;
+}
+
+int main(int argc, char** argv) {
+    const char* path = argc > 1 ? argv[1] : "bench_results.json";
+    long max_users = argc > 2 ? parseLong(argv[2]) : SIZES[SIZE_COUNT - 1];
+
+    json.put("{\n  \"suite\": \"cellsim\",\n");
+#ifdef NDEBUG
+    json.put("  \"build\": \"release\",\n");
+#else
+    json.put("  \"build\": \"debug\",\n");
+#endif
+    json.put("  \"results\": [\n");
+    for (int i = 0; i < SIZE_COUNT; ++i) {
+        long users = SIZES[i];
+        if (users > max_users) break;
+        benchAddRemove(users);
+        benchQuery(users);
+        benchAggregation(users);
+        benchRegister(users);
+        benchParser(users);
+        benchOutput(users);
+        benchCapacity(users);
+        benchStorm(users);
+        benchCoverage(users);
+    }
+    benchScheduler(TtiScheduler::POLICY_PROPORTIONAL_FAIR, "TtiScheduler::tick PF");
+    benchScheduler(TtiScheduler::POLICY_ROUND_ROBIN, "TtiScheduler::tick RR");
+    benchMimo();
+    benchPreemption();
+    benchCoreWorkers();
+    benchStartup();
+    benchWhatIf();
+    json.put("\n  ]\n}\n");
+
+    long fd = syscall3(SYS_OPEN, (long)path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        io.errorstring("❌ ERROR: cannot write ");
+        io.errorstring(path);
+        io.errorstring("\n");
+        return 1;
+    }
+    long size = json.size();
+    json.flush(fd);
+    syscall3(SYS_CLOSE, fd, 0, 0);
+    io.errorstring("Results written to ");
+    io.errorstring(path);
+    io.errorstring(" (");
+    io.errorint(static_cast<int>(size));
+    io.errorstring(" bytes)\n");
+    return 0;
+}
@@ -0,0 +1,378 @@
+#include <thread>
+#include "../include/basicIO.h"
+#include "../include/exceptions.h"
+#include "../include/NetworkConfig.h"
+#include "../include/OutBuffer.h"
+#include "../include/Clock.h"
+
+// Synthetic provisioning workload generator. Emits valid input.txt records
+// ("<gen> <service> <freq>") for the active generation profiles:
+//
+//   cellsim-gen -n <lines> [-o file] [-s seed] [-t threads]
+//               [-g 7:60,6:20,5:20] [-v 1:40,2:10,3:40,4:10]
+//               [-k uniform | zipf[:exponent] | hotspot[:traffic%[:slots%]]]
+//               [-c generations.cfg]
+//
+// Lines are produced in fixed-size chunks, each with its own RNG stream
+// derived from the seed, so the output depends only on the seed and options,
+// never on the thread count. Worker threads fill one wave of chunks while the
+// main thread writes the previous wave.
+
+#define SYS_OPEN 2
+#define SYS_CLOSE 3
+#define O_WRONLY 1
+#define O_CREAT 64
+#define O_TRUNC 512
+
+static const long CHUNK_LINES = 1L << 18;
+static const long MAX_LINE_BYTES = 24;   // "7 4 100000\n" plus slack
+static const int MAX_THREADS = 64;
+static const int GEN_COUNT = NetworkConfig::MAX_GEN + 1;
+
+enum Skew { SKEW_UNIFORM, SKEW_ZIPF, SKEW_HOTSPOT };
+
+struct Options {
+    long lines;
+    const char* out_path;
+    unsigned long seed;
+    int threads;
+    double gen_weight[GEN_COUNT];
+    double service_weight[NetworkConfig::MAX_SERVICES];
+    Skew skew;
+    double zipf_exponent;
+    int hot_traffic_pct;
+    int hot_slots_pct;
+    const char* config_path;
+};
+
+// Per-generation frequency table and sampling distribution over its slots
+struct GenTable {
+    int* freqs;
+    double* cdf;     // zipf only
+    int slot_count;
+    int hot_count;   // hotspot only
+};
+
+static GenTable tables[GEN_COUNT];
+static double gen_cdf[GEN_COUNT];
+static int gen_ids[GEN_COUNT];
+static int active_gens = 0;
+static double service_cdf[NetworkConfig::MAX_SERVICES];
+
+struct Rng {
+    unsigned long state;
+
+    static unsigned long splitmix(unsigned long x) {
+        x += 0x9e3779b97f4a7c15UL;
+        x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9UL;
+        x = (x ^ (x >> 27)) * 0x94d049bb133111ebUL;
+        return x ^ (x >> 31);
+    }
+
+    Rng(unsigned long seed, unsigned long stream) : state(splitmix(seed ^ splitmix(stream))) {
+        if (state == 0) state = 1;
+    }
+
+    unsigned long next() {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        return state * 0x2545f4914f6cdd1dUL;
+    }
+
+    double uniform() { return (next() >> 11) * (1.0 / 9007199254740992.0); }
+};
+
+static int pickFromCdf(const double* cdf, int n, double u) {
+    int lo = 0, hi = n - 1;
+    while (lo < hi) {
+        int mid = (lo + hi) / 2;
+        if (cdf[mid] > u) hi = mid;
+        else lo = mid + 1;
+    }
+    return lo;
+}
+
+static int pickFrequency(const GenTable& t, const Options& opt, Rng& rng) {
+    if (opt.skew == SKEW_ZIPF) return t.freqs[pickFromCdf(t.cdf, t.slot_count, rng.uniform())];
+    if (opt.skew == SKEW_HOTSPOT && static_cast<int>(rng.next() % 100) < opt.hot_traffic_pct)
+        return t.freqs[rng.next() % t.hot_count];
+    return t.freqs[rng.next() % t.slot_count];
+}
+
+static void generateChunk(const Options& opt, long chunk, long lines, OutBuffer& out) {
+    Rng rng(opt.seed, static_cast<unsigned long>(chunk));
+    out.clear();
+    for (long i = 0; i < lines; ++i) {
+        int gen = gen_ids[pickFromCdf(gen_cdf, active_gens, rng.uniform())];
+        int service = 1 + pickFromCdf(service_cdf + 1, NetworkConfig::MAX_SERVICES - 1, rng.uniform());
+        out.putInt(gen).put(' ').putInt(service).put(' ').putInt(pickFrequency(tables[gen], opt, rng)).put('\n');
+    }
+}
+
+static void buildTables(const Options& opt) {
+    double total = 0;
+    for (int g = NetworkConfig::MIN_GEN; g <= NetworkConfig::MAX_GEN; ++g) total += opt.gen_weight[g];
+    double acc = 0;
+    for (int g = NetworkConfig::MIN_GEN; g <= NetworkConfig::MAX_GEN; ++g) {
+        if (opt.gen_weight[g] <= 0) continue;
+        acc += opt.gen_weight[g] / total;
+        gen_ids[active_gens] = g;
+        gen_cdf[active_gens++] = acc;
+
+        const NetworkConfig& cfg = NetworkConfig::profile(g);
+        GenTable& t = tables[g];
+        t.slot_count = cfg.getSlotCount();
+        t.freqs = new int[t.slot_count];
+        int k = 0;
+        for (int b = 0; b < cfg.band_count; ++b)
+            for (int i = 0; i < cfg.bands[b].count; ++i)
+                t.freqs[k++] = cfg.bands[b].start_mhz + i * cfg.bands[b].step_mhz;
+        t.hot_count = (t.slot_count * opt.hot_slots_pct + 99) / 100;
+        if (t.hot_count < 1) t.hot_count = 1;
+        t.cdf = nullptr;
+        if (opt.skew == SKEW_ZIPF) {
+            // P(rank r) ~ 1 / r^s, with s = zipf_exponent; rank 1 is the first slot
+            t.cdf = new double[t.slot_count];
+            double norm = 0;
+            for (int r = 0; r < t.slot_count; ++r) {
+                t.cdf[r] = 1.0 / __builtin_pow(r + 1.0, opt.zipf_exponent);
+                norm += t.cdf[r];
+            }
+            double run = 0;
+            for (int r = 0; r < t.slot_count; ++r) {
+                run += t.cdf[r] / norm;
+                t.cdf[r] = run;
+            }
+            t.cdf[t.slot_count - 1] = 1.0;
+        }
+    }
+    gen_cdf[active_gens - 1] = 1.0;
+
+    double s_total = 0;
+    for (int s = 1; s < NetworkConfig::MAX_SERVICES; ++s) s_total += opt.service_weight[s];
+    double s_acc = 0;
+    for (int s = 1; s < NetworkConfig::MAX_SERVICES; ++s) {
+        s_acc += opt.service_weight[s] / s_total;
+        service_cdf[s] = s_acc;
+    }
+    service_cdf[NetworkConfig::MAX_SERVICES - 1] = 1.0;
+}
+
+// --- argument parsing ---
+
+static bool equals(const char* a, const char* b) {
+    while (*a && *a == *b) { ++a; ++b; }
+    return *a == *b;
+}
+
+static bool startsWith(const char* s, const char* prefix) {
+    while (*prefix) if (*s++ != *prefix++) return false;
+    return true;
+}
+
+static const char* parseNumber(const char* s, double& value) {
+    double v = 0, div = 1;
+    bool frac = false, any = false;
+    for (; (*s >= '0' && *s <= '9') || (*s == '.' && !frac); ++s) {
+        if (*s == '.') { frac = true; continue; }
+        v = v * 10 + (*s - '0');
+        if (frac) div *= 10;
+        any = true;
+    }
+    value = any ? v / div : -1;
+    return s;
+}
+
+// "7:60,6:20" -> weights[7] = 60, weights[6] = 20, everything else 0
+static bool parseMix(const char* s, double* weights, int lo, int hi) {
+    for (int i = lo; i <= hi; ++i) weights[i] = 0;
+    bool any = false;
+    while (*s) {
+        double key, weight;
+        s = parseNumber(s, key);
+        if (*s != ':') return false;
+        s = parseNumber(s + 1, weight);
+        if (key < lo || key > hi || weight < 0) return false;
+        weights[static_cast<int>(key)] = weight;
+        if (weight > 0) any = true;
+        if (*s == ',') ++s;
+        else if (*s) return false;
+    }
+    return any;
+}
+
+static void usage() {
+    io.errorstring("usage: cellsim-gen -n <lines> [-o file] [-s seed] [-t threads]\n"
+                   "                   [-g gen:weight,...] [-v service:weight,...]\n"
+                   "                   [-k uniform|zipf[:s]|hotspot[:traffic%[:slots%]]] [-c config]\n");
+}
+
+static bool parseArgs(int argc, char** argv, Options& opt) {
+    opt.lines = -1;
+    opt.out_path = nullptr;
+    opt.seed = 1;
+    opt.threads = static_cast<int>(std::thread::hardware_concurrency());
+    if (opt.threads < 1) opt.threads = 1;
+    for (int g = 0; g < GEN_COUNT; ++g) opt.gen_weight[g] = (g >= NetworkConfig::MIN_GEN) ? 1 : 0;
+    for (int s = 0; s < NetworkConfig::MAX_SERVICES; ++s) opt.service_weight[s] = (s >= 1) ? 1 : 0;
+    opt.skew = SKEW_UNIFORM;
+    opt.zipf_exponent = 1.0;
+    opt.hot_traffic_pct = 80;
+    opt.hot_slots_pct = 10;
+    opt.config_path = "generations.cfg";
+
+    for (int i = 1; i < argc; ++i) {
+        const char* flag = argv[i];
+        if (i + 1 >= argc) return false;
+        const char* value = argv[++i];
+        double v;
+        if (equals(flag, "-n")) {
+            parseNumber(value, v);
+            if (v < 0) return false;
+            opt.lines = static_cast<long>(v);
+        } else if (equals(flag, "-o")) {
+            opt.out_path = value;
+        } else if (equals(flag, "-s")) {
+            parseNumber(value, v);
+            if (v < 0) return false;
+            opt.seed = static_cast<unsigned long>(v);
+        } else if (equals(flag, "-t")) {
+            parseNumber(value, v);
+            if (v < 1 || v > MAX_THREADS) return false;
+            opt.threads = static_cast<int>(v);
+        } else if (equals(flag, "-g")) {
+            if (!parseMix(value, opt.gen_weight, NetworkConfig::MIN_GEN, NetworkConfig::MAX_GEN)) return false;
+        } else if (equals(flag, "-v")) {
+            if (!parseMix(value, opt.service_weight, 1, NetworkConfig::MAX_SERVICES - 1)) return false;
+        } else if (equals(flag, "-k")) {
+            if (equals(value, "uniform")) {
+                opt.skew = SKEW_UNIFORM;
+            } else if (startsWith(value, "zipf")) {
+                opt.skew = SKEW_ZIPF;
+                if (value[4] == ':') {
+                    parseNumber(value + 5, opt.zipf_exponent);
+                    if (opt.zipf_exponent <= 0) return false;
+                }
+            } else if (startsWith(value, "hotspot")) {
+                opt.skew = SKEW_HOTSPOT;
+                const char* p = value + 7;
+                if (*p == ':') {
+                    p = parseNumber(p + 1, v);
+                    if (v < 0 || v > 100) return false;
+                    opt.hot_traffic_pct = static_cast<int>(v);
+                    if (*p == ':') {
+                        parseNumber(p + 1, v);
+                        if (v <= 0 || v > 100) return false;
+                        opt.hot_slots_pct = static_cast<int>(v);
+                    }
+                }
+            } else {
+                return false;
+            }
+        } else if (equals(flag, "-c")) {
+            opt.config_path = value;
+        } else {
+            return false;
+        }
+    }
+    if (opt.threads > MAX_THREADS) opt.threads = MAX_THREADS;
+    return opt.lines >= 0;
+}
+
+static bool writeAll(long fd, const OutBuffer& buf) {
+    long written = 0;
+    while (written < buf.size()) {
+        long n = syscall3(1, fd, (long)(buf.data() + written), buf.size() - written);
+        if (n <= 0) return false;
+        written += n;
+    }
+    return true;
+}
+
+int main(int argc, char** argv) {
+    Options opt;
+    if (!parseArgs(argc, argv, opt)) {
+        usage();
+        return 2;
+    }
+    try {
+        NetworkConfig::loadFile(opt.config_path);
+    } catch (const InvalidConfigException& e) {
+        io.errorstring("ERROR: ");
+        io.errorstring(e.what());
+        io.errorstring("\n");
+        return 1;
+    }
+    buildTables(opt);
+
+    long fd = 1;
+    if (opt.out_path) {
+        fd = syscall3(SYS_OPEN, (long)opt.out_path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (fd < 0) {
+            io.errorstring("❌ ERROR: cannot open ");
+            io.errorstring(opt.out_path);
+            io.errorstring("\n");
+            return 1;
+        }
+    }
+
+    char header_storage[160];
+    OutBuffer header(header_storage, sizeof(header_storage));
+    header.put("# generated by cellsim-gen: lines=").putInt(opt.lines)
+          .put(" seed=").putInt(static_cast<long>(opt.seed)).put('\n');
+    writeAll(fd, header);
+
+    // Two waves of per-thread chunk buffers: one being filled, one being written
+    int t_count = opt.threads;
+    long chunk_bytes = CHUNK_LINES * MAX_LINE_BYTES;
+    char* storage = new char[2L * t_count * chunk_bytes];
+    OutBuffer* buffers[2][MAX_THREADS];
+    for (int w = 0; w < 2; ++w)
+        for (int t = 0; t < t_count; ++t)
+            buffers[w][t] = new OutBuffer(storage + (static_cast<long>(w) * t_count + t) * chunk_bytes, chunk_bytes);
+
+    long start = Clock::nowNs();
+    long chunks = (opt.lines + CHUNK_LINES - 1) / CHUNK_LINES;
+    long bytes = header.size();
+    bool ok = true;
+    int pending = 0;   // chunks in the previously generated wave
+    int wave = 0;
+    for (long first = 0; first < chunks || pending > 0; first += t_count, wave ^= 1) {
+        int count = 0;
+        std::thread workers[MAX_THREADS];
+        for (; count < t_count && first + count < chunks; ++count) {
+            long chunk = first + count;
+            long lines = opt.lines - chunk * CHUNK_LINES;
+            if (lines > CHUNK_LINES) lines = CHUNK_LINES;
+            OutBuffer* out = buffers[wave][count];
+            workers[count] = std::thread([&opt, chunk, lines, out]() { generateChunk(opt, chunk, lines, *out); });
+        }
+        // Write the previous wave while this one generates
+        for (int t = 0; t < pending && ok; ++t) {
+            ok = writeAll(fd, *buffers[wave ^ 1][t]);
+            bytes += buffers[wave ^ 1][t]->size();
+        }
+        for (int t = 0; t < count; ++t) workers[t].join();
+        pending = count;
+    }
+    long elapsed_us = Clock::elapsedUs(start);
+    if (fd != 1) syscall3(SYS_CLOSE, fd, 0, 0);
+
+    for (int w = 0; w < 2; ++w)
+        for (int t = 0; t < t_count; ++t) delete buffers[w][t];
+    delete[] storage;
+
+    if (!ok) {
+        io.errorstring("❌ ERROR: write failed\n");
+        return 1;
+    }
+    io.errorstring("Generated ");
+    io.errorint(static_cast<int>(opt.lines));
+    io.errorstring(" lines (");
+    io.errorint(static_cast<int>(bytes >> 20));
+    io.errorstring(" MB) in ");
+    io.errorint(static_cast<int>(elapsed_us / 1000));
+    io.errorstring(" ms\n");
+    return 0;
+}
@@ -2,6 +2,24 @@
 #include "../include/exceptions.h"
 #include "../include/InputValidator.h"
 #include "../include/GenerationManager.h"
+#include "../include/NetworkConfig.h"
+#include "../include/Topology.h"
+#include "../include/Coverage.h"
+#include "../include/FallbackChain.h"
+#include "../include/InputParser.h"
+#include "../include/OutBuffer.h"
+#include "../include/Perf.h"
+#include "../include/Trace.h"
+#include "../include/TraceReplay.h"
+#include "../include/Dashboard.h"
+#include "../include/MetricsExport.h"
+#include "../include/ControlServer.h"
+#include "../include/FileIO.h"
+#include "../include/Scheduler.h"
+#include "../include/MimoGrouping.h"
+#include "../include/CoreWorkers.h"
+#include "../include/SignallingStorm.h"
+#include "../include/WhatIf.h"
 
 extern "C" long syscall3(long, long, long, long);
 
@@ -9,6 +27,7 @@ extern "C" long syscall3(long, long, long, long);
 #define SYS_WRITE 1
 #define SYS_OPEN 2
 #define SYS_CLOSE 3
+#define SYS_LSEEK 8
 #define O_RDONLY 0
 #define O_WRONLY 1
 #define O_CREAT 64
@@ -19,20 +38,121 @@ extern "C" long syscall3(long, long, long, long);
 GenerationManager* gen_managers[8] = {nullptr};
 CellularCore<long>* gen_cores[8] = {nullptr}; // ADD THIS LINE
 
+// 🔥 File Mode engines: built on first use, then reset rather than rebuilt
+GenerationManager* file_managers[8] = {nullptr};
+CellularCore<long>* file_cores[8] = {nullptr};
+
+// 🔥 Auto placement settings shared by both modes
+GenerationManager::PlacementPolicy placement_policy = GenerationManager::PLACE_FIRST_FIT;
+bool spill_on_full = false;
+bool preemption_enabled = false;   // 🔥 QoS preemption, applied to every generation
+
+GenerationManager* ensureManager(int gen);
+GenerationManager& fileManager(int gen);
+FallbackChain fallback_chain(ensureManager); // 🔥 5G -> 4G+ -> 4G ... when full
+
 void runInteractiveMode();
 void runFileMode();
+void runTopologyMode();
+void runCoverageMode();
+void printTechnologyMenu();
+void printSpectrumStatus(const GenerationManager& manager);
+void printAvailableFrequencies(const GenerationManager& manager);
+void printNetworkStats(const GenerationManager& manager);
+void choosePlacementPolicy();
+void showFallbackMenu();
+void showPerfStats();
+int runHeadless(const char* path, const char* export_path);
+bool exportMetrics(const char* path);
+void showExportMenu();
+void runSchedulerMenu(const GenerationManager& manager);
+void runMimoMenu(GenerationManager& manager);
+void showQosMenu(const GenerationManager& manager);
+void runWorkersMenu(const GenerationManager& manager);
+void runStormMenu(const GenerationManager& manager);
+void runWhatIf(int gen);
+int runServer(const char* path);
+int runReplay(const char* path);
+void runWatchMode();
+int runWatchReplay(const char* path, int hz, int speed);
 
-extern "C" int main() {
+// Plans larger than this are summarised per band and paged
+static const int SPECTRUM_PAGE_SIZE = 32;
+
+static bool argEquals(const char* a, const char* b) {
+    while (*a && *a == *b) { ++a; ++b; }
+    return *a == *b;
+}
+
+static int parseArgInt(const char* s) {
+    int v = 0;
+    while (*s >= '0' && *s <= '9') v = v * 10 + (*s++ - '0');
+    return v;
+}
+
+extern "C" int main(int argc, char** argv) {
     basicIO io;
+    // 🔥 Generation profiles: parsed + validated once, built-in defaults if absent
+    try {
+        NetworkConfig::loadFile("generations.cfg");
+    } catch (const InvalidConfigException& e) {
+        io.errorstring("ERROR: ");
+        io.errorstring(e.what());
+        io.errorstring(" - using built-in generation defaults\n");
+    }
+    // 🔥 COMMAND LINE: --record <trace> (with any mode), then
+    //    --headless [input.txt] - no menus, stats on exit (--export <file.json|file.csv>)
+    //    --replay <trace>        - re-execute a recorded session silently
+    //    --watch <trace> [hz] [speed] - replay at recorded pace on a live dashboard
+    //    --serve [socket]        - control/query server on a Unix socket
+    //    --io sync|uring         - file I/O backend (io_uring when available)
+    for (int i = 1; i + 1 < argc; ++i) {
+        if (argEquals(argv[i], "--record") && !Trace::start(argv[i + 1])) {
+            io.errorstring("❌ ERROR: cannot write trace ");
+            io.errorstring(argv[i + 1]);
+            io.errorstring("\n");
+            return 1;
+        }
+    }
+    const char* export_path = nullptr;
+    for (int i = 1; i + 1 < argc; ++i) {
+        if (argEquals(argv[i], "--export")) export_path = argv[i + 1];
+        if (argEquals(argv[i], "--io")) FileIO::setUringEnabled(!argEquals(argv[i + 1], "sync"));
+    }
+    for (int i = 1; i < argc; ++i) {
+        if (argEquals(argv[i], "--record") || argEquals(argv[i], "--export") || argEquals(argv[i], "--io")) {
+            ++i;
+        } else if (argEquals(argv[i], "--replay") && i + 1 < argc) {
+            return runReplay(argv[i + 1]);
+        } else if (argEquals(argv[i], "--watch") && i + 1 < argc) {
+            int hz = i + 2 < argc ? parseArgInt(argv[i + 2]) : 10;
+            int speed = i + 3 < argc ? parseArgInt(argv[i + 3]) : 1;
+            return runWatchReplay(argv[i + 1], hz, speed);
+        } else if (argEquals(argv[i], "--serve")) {
+            bool has_path = i + 1 < argc && argv[i + 1][0] != '-';
+            int rc = runServer(has_path ? argv[i + 1] : "cellsim.sock");
+            Trace::stop();
+            return rc;
+        } else if (argEquals(argv[i], "--headless")) {
+            bool has_path = i + 1 < argc && argv[i + 1][0] != '-';
+            int rc = runHeadless(has_path ? argv[i + 1] : "input.txt", export_path);
+            Trace::stop();
+            return rc;
+        }
+    }
     while (1) {
         try {
             io.outputstring("\n=== Cellular Network Simulator ===\n");
             io.outputstring("1. Interactive Mode (User-Driven)\n");
             io.outputstring("2. File Mode (Input File Simulation)\n");
             io.outputstring("3. Exit\n");
-            io.outputstring("Choose mode (1-3): ");
+            io.outputstring("4. Multi-Cell Topology (Handover)\n");
+            io.outputstring("5. Performance Stats\n");
+            io.outputstring("6. Watch Mode (Live Utilisation)\n");
+            io.outputstring("7. Coverage Map (User-to-Tower Assignment)\n");
+            io.outputstring("Choose mode (1-7): ");
             
-            int mode = InputValidator::validateInt(1, 3);
+            int mode = InputValidator::validateInt(1, 7);
             
             if (mode == 1) {
                 runInteractiveMode();
@@ -40,7 +160,16 @@ extern "C" int main() {
                 runFileMode();
             } else if (mode == 3) {
                 io.outputstring("Goodbye!\n");
+                Trace::stop();
                 break;
+            } else if (mode == 4) {
+                runTopologyMode();
+            } else if (mode == 5) {
+                showPerfStats();
+            } else if (mode == 6) {
+                runWatchMode();
+            } else if (mode == 7) {
+                runCoverageMode();
             }
         }
         catch (const OutOfRangeException& e) {
@@ -65,14 +194,7 @@ void runInteractiveMode() {
     GenerationManager* current_manager = nullptr;
     
     while (1) {
-        io.outputstring("\n--- Select Network Technology ---\n");
-        io.outputstring("2: 2G (TDMA) - Voice:15, Data:5 msgs\n");
-        io.outputstring("3: 3G (CDMA) - Fixed 10 msgs\n");
-        io.outputstring("4: 3.5G (HSPA) - Fixed 8 msgs\n");
-        io.outputstring("5: 4G (OFDM) - Service-based messages\n");
-        io.outputstring("6: 4G+ (LTE-A) - Enhanced capacity\n");
-        io.outputstring("7: 5G (Massive MIMO) - 16x antenna reuse\n");
-        io.outputstring("0: Return to Main Menu\n");
+        printTechnologyMenu();
         io.outputstring("Choice (2-7, 0 to exit): ");
         
         int gen = InputValidator::validateInt(0, 7);
@@ -83,14 +205,8 @@ void runInteractiveMode() {
             continue;
         }
         
-        // Replace 10000 with 100
-static CellularCore<long> shared_core(100); // 🔥 100 message limit
-if (gen_managers[gen] == nullptr) {
-    gen_cores[gen] = new CellularCore<long>(100);          // NEW: dedicated core
-    gen_managers[gen] = new GenerationManager(gen, gen_cores[gen]);
-}
         current_gen_unused = gen;
-        current_manager = gen_managers[gen];
+        current_manager = ensureManager(gen);
         
         while (1) {
             io.outputstring("\n[Interactive Mode - ");
@@ -103,9 +219,18 @@ if (gen_managers[gen] == nullptr) {
             io.outputstring("5. View Network Stats\n");
             io.outputstring("6. Switch Technology\n");
             io.outputstring("7. Return to Main Menu\n");
+            io.outputstring("8. Placement Policy\n");
+            io.outputstring("9. Fallback Admission\n");
+            io.outputstring("10. Export Metrics (JSON/CSV)\n");
+            io.outputstring("11. TTI Scheduler Simulation (4G/4G+/5G)\n");
+            io.outputstring("12. MU-MIMO User Grouping (4G/4G+/5G)\n");
+            io.outputstring("13. QoS Admission & Preemption\n");
+            io.outputstring("14. Core Workers (work stealing)\n");
+            io.outputstring("15. Signalling Storm\n");
+            io.outputstring("16. What-if Fork (try changes, then discard)\n");
             io.outputstring("Choice: ");
             
-            int c = InputValidator::validateInt(1, 7);
+            int c = InputValidator::validateInt(1, 16);
 
             if (c == 1) { // 🔥 ADD USER (was Remove)
                 if (current_manager->getUserCount() >= 1000) {
@@ -121,29 +246,11 @@ if (gen_managers[gen] == nullptr) {
                 io.outputstring("Choice (1-4): ");
                 int service = InputValidator::validateInt(1, 4);
                 
-                io.outputstring("\n--- Available Frequencies ---\n");
-                bool has_space = false;
-                for (int i = 0; i < current_manager->getSlotCount(); ++i) {
-                    int used = current_manager->getSlotUsers(i);
-                    int total = current_manager->getSlotMaxUsers(i);
-                    if (used < total) {
-                        io.outputstring("  ");
-                        io.outputint(current_manager->getSlotFrequency(i));
-                        io.outputstring(" MHz (");
-                        io.outputint(used);
-                        io.outputstring("/");
-                        io.outputint(total);
-                        io.outputstring(" users)\n");
-                        has_space = true;
-                    }
-                }
-                if (!has_space) {
-                    io.outputstring("  (No frequencies with available space)\n");
-                }
-                io.outputstring("\nEnter Frequency (MHz): ");
-                int freq = InputValidator::validateInt(1, 100000);
+                printAvailableFrequencies(*current_manager);
+                io.outputstring("\nEnter Frequency (MHz, 0 = auto): ");
+                int freq = InputValidator::validateInt(0, 100000);
                 
-                if (!current_manager->isValidFrequency(freq)) {
+                if (freq != 0 && !current_manager->isValidFrequency(freq)) {
                     io.errorstring("❌ ERROR: Frequency ");
                     io.errorint(freq);
                     io.errorstring(" MHz is not valid for ");
@@ -151,8 +258,36 @@ if (gen_managers[gen] == nullptr) {
                     io.errorstring(" generation.\n");
                     continue;
                 }
+
+                // 🔥 Data users may aggregate carriers where the profile allows it
+                int carriers = 1;
+                if (current_manager->getMaxCarriers() > 1 && service >= 3) {
+                    io.outputstring("Component carriers (1-");
+                    io.outputint(current_manager->getMaxCarriers());
+                    io.outputstring("): ");
+                    carriers = InputValidator::validateInt(1, current_manager->getMaxCarriers());
+                }
                 
-                current_manager->addUser(service, freq);
+                if (!fallback_chain.isEnabled()) {
+                    current_manager->addUserPlaced(service, freq, carriers);
+                    continue;
+                }
+                int carried_freq = 0;
+                GenerationManager::AdmitResult first;
+                int carried_gen = fallback_chain.admit(gen, service, freq, carried_freq, first, carriers);
+                if (carried_gen == gen) {
+                    io.outputstring("✅ User added successfully.\n");
+                } else if (carried_gen != 0) {
+                    io.outputstring("✅ ");
+                    io.outputstring(current_manager->getTechName());
+                    io.outputstring(" full - user carried by ");
+                    io.outputstring(gen_managers[carried_gen]->getTechName());
+                    io.outputstring(" on ");
+                    io.outputint(carried_freq);
+                    io.outputstring(" MHz.\n");
+                } else {
+                    io.errorstring("❌ Rejected: no generation in the fallback chain has capacity.\n");
+                }
                 
               
             } 
@@ -169,38 +304,13 @@ if (gen_managers[gen] == nullptr) {
                 io.outputstring("User removed.\n");
             } 
             else if (c == 3) {
-                io.outputstring("\n--- SPECTRUM STATUS ---\n");
-                for (int i = 0; i < current_manager->getSlotCount(); ++i) {
-                    int used = current_manager->getSlotUsers(i);
-                    int total = current_manager->getSlotMaxUsers(i);
-                    io.outputstring("  ");
-                    io.outputint(current_manager->getSlotFrequency(i));
-                    io.outputstring(" MHz: ");
-                    io.outputint(used);
-                    io.outputstring("/");
-                    io.outputint(total);
-                    io.outputstring(" users (");
-                    if (total > 0) {
-                        io.outputint((used * 100) / total);
-                        io.outputstring("%)");
-                    } else {
-                        io.outputstring("Invalid%)");
-                    }
-                    io.terminate();
-                }
+                printSpectrumStatus(*current_manager);
             }
             else if (c == 4) {
                 io.outputstring("Frequency to query (MHz): ");
                 int f = InputValidator::validateInt(1, 100000);
                 
-                bool valid_freq = false;
-                for (int i = 0; i < current_manager->getSlotCount(); ++i) {
-                    if (current_manager->getSlotFrequency(i) == f) {
-                        valid_freq = true;
-                        break;
-                    }
-                }
-                if (!valid_freq) {
+                if (!current_manager->isValidFrequency(f)) {
                     io.errorstring("❌ ERROR: Frequency ");
                     io.errorint(f);
                     io.errorstring(" MHz is not valid for ");
@@ -230,31 +340,17 @@ if (gen_managers[gen] == nullptr) {
                         else if (service == 2) io.outputstring("SMS");
                         else if (service == 3) io.outputstring("Data");
                         else io.outputstring("Voice+Data");
+                        if (users_on_freq[i].getCarrierCount() > 1) {
+                            io.outputstring(" | ");
+                            io.outputint(users_on_freq[i].getCarrierCount());
+                            io.outputstring(" carriers");
+                        }
                         io.terminate();
                     }
                 }
             } 
             else if (c == 5) {
-                io.outputstring("\n--- Network Configuration ---\n");
-                io.outputstring("Technology: ");
-                io.outputstring(current_manager->getTechName());
-                io.terminate();
-                io.outputstring("Protocol: ");
-                io.outputstring(current_manager->getProtocol());
-                io.terminate();
-                io.outputstring("Spectrum: ");
-                io.outputint(static_cast<int>(current_manager->getTotalSpectrumMHz()));
-                io.outputstring(" MHz");
-                io.terminate();
-                io.outputstring("Max Users (Spectrum): ");
-                io.outputint(current_manager->getMaxUsersBySpectrum());
-                io.terminate();
-                io.outputstring("Current Users: ");
-                io.outputint(current_manager->getUserCount());
-                io.terminate();
-                io.outputstring("Cores Needed for Full Capacity: ");
-                io.outputint(current_manager->getCoresNeededForFull());
-                io.terminate();
+                printNetworkStats(*current_manager);
             } 
             else if (c == 6) {
                 break; // Return to technology selection
@@ -262,6 +358,39 @@ if (gen_managers[gen] == nullptr) {
             else if (c == 7) {
                 return; // Exit to main menu
             }
+            else if (c == 8) {
+                choosePlacementPolicy();
+                for (int g = 2; g <= 7; ++g) {
+                    if (gen_managers[g]) gen_managers[g]->setPlacementPolicy(placement_policy, spill_on_full);
+                }
+            }
+            else if (c == 9) {
+                showFallbackMenu();
+            }
+            else if (c == 10) {
+                showExportMenu();
+            }
+            else if (c == 11) {
+                runSchedulerMenu(*current_manager);
+            }
+            else if (c == 12) {
+                runMimoMenu(*current_manager);
+            }
+            else if (c == 13) {
+                showQosMenu(*current_manager);
+                for (int g = 2; g <= 7; ++g) {
+                    if (gen_managers[g]) gen_managers[g]->setPreemption(preemption_enabled);
+                }
+            }
+            else if (c == 14) {
+                runWorkersMenu(*current_manager);
+            }
+            else if (c == 15) {
+                runStormMenu(*current_manager);
+            }
+            else if (c == 16) {
+                runWhatIf(gen);
+            }
         }
     }
 }
@@ -273,14 +402,7 @@ void runFileMode() {
     int local_gen = 0;
 
     // 🔥 SELECT GENERATION FIRST
-    io.outputstring("\n--- Select Network Technology ---\n");
-    io.outputstring("2: 2G (TDMA) - Voice:15, Data:5 msgs\n");
-    io.outputstring("3: 3G (CDMA) - Fixed 10 msgs\n");
-    io.outputstring("4: 3.5G (HSPA) - Fixed 8 msgs\n");
-    io.outputstring("5: 4G (OFDM) - Service-based messages\n");
-    io.outputstring("6: 4G+ (LTE-A) - Enhanced capacity\n");
-    io.outputstring("7: 5G (Massive MIMO) - 16x antenna reuse\n");
-    io.outputstring("0: Return to Main Menu\n");
+    printTechnologyMenu();
     io.outputstring("Choice (2-7, 0 to exit): ");
     
     local_gen = InputValidator::validateInt(0, 7);
@@ -291,75 +413,33 @@ void runFileMode() {
         return;
     }
     
-   CellularCore<long> local_core(100); // 🔥 100 message limit
-// Independent core for file mode
-GenerationManager local_manager(local_gen, &local_core);
-
-    // 🔥 PROCESS INPUT.TXT FOR SELECTED GENERATION
-    long fd = syscall3(SYS_OPEN, (long)"input.txt", O_RDONLY, 0);
-    if (fd >= 0) {
-        char file_buf[8192];
-        long bytes = syscall3(SYS_READ, fd, (long)file_buf, 8191);
-        syscall3(SYS_CLOSE, fd, 0, 0);
-        if (bytes > 0) {
-            file_buf[bytes] = '\0';
-            int pos = 0;
-            while (pos < bytes) {
-                // Skip comments/empty lines
-                while (pos < bytes && (file_buf[pos] == '#' || file_buf[pos] == '\n' || file_buf[pos] == '\r')) {
-                    while (pos < bytes && file_buf[pos] != '\n') ++pos;
-                    ++pos;
-                }
-                if (pos >= bytes) break;
+    // Independent core for file mode, reused (reset) across technology switches
+    GenerationManager& local_manager = fileManager(local_gen);
+    local_manager.setPlacementPolicy(placement_policy, spill_on_full);
+    // User ids here are input.txt line positions, and an eviction would drop
+    // a user from the engine while its line stays in the file: no preemption
+    local_manager.setPreemption(false);
+    if (preemption_enabled) io.outputstring("⚠️ QoS preemption does not apply in File Mode.\n");
 
-                if (pos >= bytes || file_buf[pos] < '2' || file_buf[pos] > '7') {
-                    while (pos < bytes && file_buf[pos] != '\n') ++pos;
-                    ++pos;
-                    continue;
-                }
-                
-                int file_gen = file_buf[pos] - '0';
-                ++pos;
-                
-                if (file_gen != local_gen) {
-                    // Skip line if not current generation
-                    while (pos < bytes && file_buf[pos] != '\n') ++pos;
-                    ++pos;
-                    continue;
-                }
-                
-                // Skip whitespace
-                while (pos < bytes && (file_buf[pos] == ' ' || file_buf[pos] == '\t')) ++pos;
-                if (pos >= bytes) break;
-                
-                // Parse service
-                if (file_buf[pos] < '1' || file_buf[pos] > '4') {
-                    while (pos < bytes && file_buf[pos] != '\n') ++pos;
-                    ++pos;
-                    continue;
-                }
-                int service = file_buf[pos] - '0';
-                ++pos;
-                
-                // Skip whitespace
-                while (pos < bytes && (file_buf[pos] == ' ' || file_buf[pos] == '\t')) ++pos;
-                if (pos >= bytes) break;
-                
-                // Parse frequency
-                int freq = 0;
-                while (pos < bytes && file_buf[pos] >= '0' && file_buf[pos] <= '9') {
-                    freq = freq * 10 + (file_buf[pos] - '0');
-                    ++pos;
-                }
-                
-                // Skip to next line
-                while (pos < bytes && file_buf[pos] != '\n') ++pos;
-                ++pos;
-                
-                // 🔥 ADD USER TO LOCAL MANAGER
-                local_manager.addUser(service, freq);
-            }
+    // 🔥 PROCESS INPUT.TXT FOR SELECTED GENERATION: records are parsed as
+    // each run of complete lines arrives, while later reads are still in flight
+    {
+        PERF_SCOPE(T_PARSE);
+        long bytes = 0;
+        long records = 0;
+        char* file_buf = FileIO::load("input.txt", bytes, [&](const char* lines, long len) {
+            // 🔥 ADD USER TO LOCAL MANAGER (frequency 0 / "auto" = automatic placement)
+            records += InputParser::forEachRecord(lines, len, local_gen, [&](int service, int freq, int carriers) {
+                local_manager.addUserPlaced(service, freq, carriers);
+            });
+        });
+        long body_bytes = 0;
+        if (file_buf && FileIO::checkChecksum(file_buf, bytes, body_bytes) == FileIO::CHECKSUM_BAD) {
+            io.errorstring("⚠️ WARNING: input.txt does not match its save checksum (edited or damaged since the last save)\n");
         }
+        delete[] file_buf;
+        PERF_COUNT_N(PARSED_RECORDS, records);
+        (void)records;
     }
 
     // 🔥 PERSISTENT FILE MODE MENU
@@ -389,133 +469,64 @@ GenerationManager local_manager(local_gen, &local_core);
                 int id = InputValidator::validateInt(1, local_manager.getUserCount());
                 
                 // 🔥 PRESERVE ALL GENERATIONS: READ ENTIRE FILE, MODIFY ONLY CURRENT GEN
-                long orig_fd = syscall3(SYS_OPEN, (long)"input.txt", O_RDONLY, 0);
-                if (orig_fd < 0) {
+                long orig_bytes = 0;
+                char* orig_buf = FileIO::load("input.txt", orig_bytes, [](const char*, long) {});
+                if (!orig_buf) {
                     // No file exists - create with current gen only
                     local_manager.removeUser(id);
                     io.outputstring("User removed.\n");
                     continue;
                 }
-                
-                char orig_buf[8192];
-                long orig_bytes = syscall3(SYS_READ, orig_fd, (long)orig_buf, 8191);
-                syscall3(SYS_CLOSE, orig_fd, 0, 0);
-                
-                int temp_fd = syscall3(SYS_OPEN, (long)"temp_input.txt", O_WRONLY | O_CREAT | O_TRUNC, 0644);
-                if (temp_fd >= 0) {
-                    int orig_pos = 0;
-                    int user_counter = 0;
-                    while (orig_pos < orig_bytes) {
-                        // Copy comments/empty lines as-is
-                        if (orig_buf[orig_pos] == '#') {
-                            while (orig_pos < orig_bytes && orig_buf[orig_pos] != '\n') {
-                                char ch = orig_buf[orig_pos];
-                                syscall3(SYS_WRITE, temp_fd, (long)&ch, 1);
-                                ++orig_pos;
-                            }
-                            if (orig_pos < orig_bytes) {
-                                char nl = '\n';
-                                syscall3(SYS_WRITE, temp_fd, (long)&nl, 1);
-                                ++orig_pos;
-                            }
-                            continue;
-                        }
-                        
-                        if (orig_pos >= orig_bytes || orig_buf[orig_pos] < '2' || orig_buf[orig_pos] > '7') {
-                            // Copy non-data lines as-is
-                            while (orig_pos < orig_bytes && orig_buf[orig_pos] != '\n') {
-                                char ch = orig_buf[orig_pos];
-                                syscall3(SYS_WRITE, temp_fd, (long)&ch, 1);
-                                ++orig_pos;
-                            }
-                            if (orig_pos < orig_bytes) {
-                                char nl = '\n';
-                                syscall3(SYS_WRITE, temp_fd, (long)&nl, 1);
-                                ++orig_pos;
-                            }
-                            continue;
-                        }
-                        
-                        int file_gen = orig_buf[orig_pos] - '0';
-                        int line_start = orig_pos;
-                        while (orig_pos < orig_bytes && orig_buf[orig_pos] != '\n') ++orig_pos;
-                        
-                        if (file_gen != local_gen) {
-                            // 🔥 COPY OTHER GENERATIONS AS-IS
-                            char line[256];
-                            int len = orig_pos - line_start;
-                            if (len > 254) len = 254;
-                            for (int k = 0; k < len; ++k) line[k] = orig_buf[line_start + k];
-                            line[len] = '\n';
-                            syscall3(SYS_WRITE, temp_fd, (long)line, len + 1);
-                        } else {
-                            // 🔥 PROCESS CURRENT GENERATION: ONLY WRITE IF NOT THE USER BEING DELETED
-                            ++user_counter;
-                            if (user_counter != id) {
-                                char line[256];
-                                int len = orig_pos - line_start;
-                                if (len > 254) len = 254;
-                                for (int k = 0; k < len; ++k) line[k] = orig_buf[line_start + k];
-                                line[len] = '\n';
-                                syscall3(SYS_WRITE, temp_fd, (long)line, len + 1);
-                            }
-                        }
-                        
-                        if (orig_pos < orig_bytes && orig_buf[orig_pos] == '\n') ++orig_pos;
+
+                // Build the new contents in memory (one line shorter at most,
+                // plus a newline if the last line had none, plus the checksum
+                // trailer) and save them atomically in one batch
+                long body_bytes = 0;
+                FileIO::checkChecksum(orig_buf, orig_bytes, body_bytes);   // old trailer is replaced
+                orig_bytes = body_bytes;
+                char* new_buf = new char[orig_bytes + 1 + FileIO::CHECKSUM_BYTES];
+                long new_bytes = 0;
+                long orig_pos = 0;
+                int user_counter = 0;
+                while (orig_pos < orig_bytes) {
+                    long line_start = orig_pos;
+                    while (orig_pos < orig_bytes && orig_buf[orig_pos] != '\n') ++orig_pos;
+                    bool keep = true;
+                    if (orig_buf[line_start] >= '2' && orig_buf[line_start] <= '7'
+                        && orig_buf[line_start] - '0' == local_gen) {
+                        // 🔥 PROCESS CURRENT GENERATION: ONLY WRITE IF NOT THE USER BEING DELETED
+                        keep = ++user_counter != id;
                     }
-                    
-                    syscall3(SYS_CLOSE, temp_fd, 0, 0);
-                    
-                    // Replace original file with temp file
-                    long orig_write_fd = syscall3(SYS_OPEN, (long)"input.txt", O_WRONLY | O_CREAT | O_TRUNC, 0644);
-                    if (orig_write_fd >= 0) {
-                        long temp_read_fd = syscall3(SYS_OPEN, (long)"temp_input.txt", O_RDONLY, 0);
-                        if (temp_read_fd >= 0) {
-                            char temp_buf[8192];
-                            long temp_bytes = syscall3(SYS_READ, temp_read_fd, (long)temp_buf, 8191);
-                            syscall3(SYS_WRITE, orig_write_fd, (long)temp_buf, temp_bytes);
-                            syscall3(SYS_CLOSE, temp_read_fd, 0, 0);
-                        }
-                        syscall3(SYS_CLOSE, orig_write_fd, 0, 0);
+                    if (keep) {
+                        // 🔥 COPY COMMENTS, OTHER GENERATIONS AND OTHER USERS AS-IS
+                        for (long k = line_start; k < orig_pos; ++k) new_buf[new_bytes++] = orig_buf[k];
+                        new_buf[new_bytes++] = '\n';
                     }
+                    if (orig_pos < orig_bytes) ++orig_pos;
                 }
-                
+                delete[] orig_buf;
+
+                new_bytes = FileIO::putChecksum(new_buf, new_bytes);
+                // 🔥 temp_input.txt + fsync + rename: a crash leaves the old or the new file, never neither
+                bool saved = FileIO::saveAtomic("input.txt", new_buf, new_bytes, "temp_input.txt");
+                delete[] new_buf;
+                if (!saved) {
+                    // Engine and file must keep matching: the user stays in both
+                    io.errorstring("❌ ERROR: could not save input.txt (left unchanged); user not removed\n");
+                    continue;
+                }
+
                 local_manager.removeUser(id);
                 io.outputstring("User removed and file updated.\n");
             } 
             else if (c == 2) { // 🔥 VIEW SPECTRUM STATUS
-                io.outputstring("\n--- SPECTRUM STATUS ---\n");
-                for (int i = 0; i < local_manager.getSlotCount(); ++i) {
-                    int used = local_manager.getSlotUsers(i);
-                    int total = local_manager.getSlotMaxUsers(i);
-                    io.outputstring("  ");
-                    io.outputint(local_manager.getSlotFrequency(i));
-                    io.outputstring(" MHz: ");
-                    io.outputint(used);
-                    io.outputstring("/");
-                    io.outputint(total);
-                    io.outputstring(" users (");
-                    if (total > 0) {
-                        io.outputint((used * 100) / total);
-                        io.outputstring("%)");
-                    } else {
-                        io.outputstring("Invalid%)");
-                    }
-                    io.terminate();
-                }
+                printSpectrumStatus(local_manager);
             }
             else if (c == 3) { // 🔥 VIEW USERS ON FREQUENCY
                 io.outputstring("Frequency to query (MHz): ");
                 int f = InputValidator::validateInt(1, 100000);
                 
-                bool valid_freq = false;
-                for (int i = 0; i < local_manager.getSlotCount(); ++i) {
-                    if (local_manager.getSlotFrequency(i) == f) {
-                        valid_freq = true;
-                        break;
-                    }
-                }
-                if (!valid_freq) {
+                if (!local_manager.isValidFrequency(f)) {
                     io.errorstring("❌ ERROR: Frequency ");
                     io.errorint(f);
                     io.errorstring(" MHz is not valid for ");
@@ -545,31 +556,17 @@ GenerationManager local_manager(local_gen, &local_core);
                         else if (service == 2) io.outputstring("SMS");
                         else if (service == 3) io.outputstring("Data");
                         else io.outputstring("Voice+Data");
+                        if (users_on_freq[i].getCarrierCount() > 1) {
+                            io.outputstring(" | ");
+                            io.outputint(users_on_freq[i].getCarrierCount());
+                            io.outputstring(" carriers");
+                        }
                         io.terminate();
                     }
                 }
             } 
             else if (c == 4) { // 🔥 VIEW NETWORK STATS
-                io.outputstring("\n--- Network Configuration ---\n");
-                io.outputstring("Technology: ");
-                io.outputstring(local_manager.getTechName());
-                io.terminate();
-                io.outputstring("Protocol: ");
-                io.outputstring(local_manager.getProtocol());
-                io.terminate();
-                io.outputstring("Spectrum: ");
-                io.outputint(static_cast<int>(local_manager.getTotalSpectrumMHz()));
-                io.outputstring(" MHz");
-                io.terminate();
-                io.outputstring("Max Users (Spectrum): ");
-                io.outputint(local_manager.getMaxUsersBySpectrum());
-                io.terminate();
-                io.outputstring("Current Users: ");
-                io.outputint(local_manager.getUserCount());
-                io.terminate();
-                io.outputstring("Cores Needed for Full Capacity: ");
-                io.outputint(local_manager.getCoresNeededForFull());
-                io.terminate();
+                printNetworkStats(local_manager);
             } 
             else if (c == 5) { // 🔥 SWITCH TECHNOLOGY
                 runFileMode(); // Recursive call for new generation
@@ -587,3 +584,1007 @@ GenerationManager local_manager(local_gen, &local_core);
         }
     }
 }
+
+// 🔥 Message costs and MIMO reuse come from the loaded profiles (generations.cfg)
+void printTechnologyMenu() {
+    static const char* services[NetworkConfig::MAX_SERVICES] = {"", "Voice", "SMS", "Data", "Voice+Data"};
+    io.outputstring("\n--- Select Network Technology ---\n");
+    for (int g = NetworkConfig::MIN_GEN; g <= NetworkConfig::MAX_GEN; ++g) {
+        const NetworkConfig& cfg = NetworkConfig::profile(g);
+        char storage[256];
+        OutBuffer out(storage, sizeof(storage));
+        out.putInt(g).put(": ").put(cfg.name).put(" - ");
+        bool flat = true;
+        for (int s = 2; s < NetworkConfig::MAX_SERVICES; ++s) flat = flat && cfg.messagesFor(s) == cfg.messagesFor(1);
+        if (flat) {
+            out.put("Fixed ").putInt(cfg.messagesFor(1));
+        } else {
+            for (int s = 1; s < NetworkConfig::MAX_SERVICES; ++s)
+                out.put(s > 1 ? ", " : "").put(services[s]).put(':').putInt(cfg.messagesFor(s));
+        }
+        out.put(" msgs");
+        if (cfg.mimo_enabled) out.put(", ").putInt(cfg.antenna_factor).put("x antenna reuse");
+        out.put('\n');
+        out.flush(1);
+    }
+    io.outputstring("0: Return to Main Menu\n");
+}
+
+static void printSlotLine(const GenerationManager& manager, int i) {
+    int used = manager.getSlotUsers(i);
+    int total = manager.getSlotMaxUsers(i);
+    io.outputstring("  ");
+    io.outputint(manager.getSlotFrequency(i));
+    io.outputstring(" MHz: ");
+    io.outputint(used);
+    io.outputstring("/");
+    io.outputint(total);
+    io.outputstring(" users (");
+    if (total > 0) {
+        io.outputint(manager.getSlotUtilisation(i));
+        io.outputstring("%)");
+    } else {
+        io.outputstring("Invalid%)");
+    }
+    io.terminate();
+}
+
+static void printBandRange(const SpectrumPlan::BandRange& band) {
+    io.outputstring("  ");
+    io.outputint(band.start_mhz);
+    io.outputstring("-");
+    io.outputint(band.last_mhz());
+    io.outputstring(" MHz (step ");
+    io.outputint(band.step_mhz);
+    io.outputstring(", ");
+    io.outputint(band.count);
+    io.outputstring(" slots): ");
+}
+
+void printSpectrumStatus(const GenerationManager& manager) {
+    io.outputstring("\n--- SPECTRUM STATUS ---\n");
+    int slots = manager.getSlotCount();
+    if (slots <= SPECTRUM_PAGE_SIZE) {
+        for (int i = 0; i < slots; ++i) printSlotLine(manager, i);
+        return;
+    }
+
+    // 🔥 Large band plan: one summary line per band, then an optional page of slots
+    const SpectrumPlan& plan = manager.getSpectrum();
+    for (int b = 0; b < plan.getBandCount(); ++b) {
+        const SpectrumPlan::BandRange& band = plan.band(b); // running totals, no slot scan
+        printBandRange(band);
+        io.outputint(static_cast<int>(band.used_users));
+        io.outputstring("/");
+        io.outputint(static_cast<int>(band.capacity));
+        io.outputstring(" users (");
+        io.outputint(band.capacity > 0 ? static_cast<int>((band.used_users * 100) / band.capacity) : 0);
+        io.outputstring("%), ");
+        io.outputint(band.full_slots);
+        io.outputstring(" full\n");
+    }
+    int pages = (slots + SPECTRUM_PAGE_SIZE - 1) / SPECTRUM_PAGE_SIZE;
+    io.outputstring("Page (1-");
+    io.outputint(pages);
+    io.outputstring(", 0 to skip): ");
+    int page = InputValidator::validateInt(0, pages);
+    if (page == 0) return;
+    int first = (page - 1) * SPECTRUM_PAGE_SIZE;
+    int last = first + SPECTRUM_PAGE_SIZE;
+    if (last > slots) last = slots;
+    for (int i = first; i < last; ++i) printSlotLine(manager, i);
+}
+
+void printAvailableFrequencies(const GenerationManager& manager) {
+    io.outputstring("\n--- Available Frequencies ---\n");
+    bool has_space = false;
+    int slots = manager.getSlotCount();
+    if (slots <= SPECTRUM_PAGE_SIZE) {
+        for (int i = 0; i < slots; ++i) {
+            int used = manager.getSlotUsers(i);
+            int total = manager.getSlotMaxUsers(i);
+            if (used < total) {
+                io.outputstring("  ");
+                io.outputint(manager.getSlotFrequency(i));
+                io.outputstring(" MHz (");
+                io.outputint(used);
+                io.outputstring("/");
+                io.outputint(total);
+                io.outputstring(" users)\n");
+                has_space = true;
+            }
+        }
+    } else {
+        // 🔥 Summarise free slots per band instead of listing thousands of carriers
+        const SpectrumPlan& plan = manager.getSpectrum();
+        for (int b = 0; b < plan.getBandCount(); ++b) {
+            const SpectrumPlan::BandRange& band = plan.band(b);
+            int free_slots = band.count - band.full_slots;
+            if (free_slots == 0) continue;
+            int first_free = -1;
+            for (int i = band.first_slot; first_free < 0; ++i) {
+                if (plan[i].current_users < plan[i].max_users) first_free = plan[i].frequency_mhz;
+            }
+            printBandRange(band);
+            io.outputint(free_slots);
+            io.outputstring(" with space, first ");
+            io.outputint(first_free);
+            io.outputstring(" MHz\n");
+            has_space = true;
+        }
+    }
+    if (!has_space) {
+        io.outputstring("  (No frequencies with available space)\n");
+    }
+}
+
+void printNetworkStats(const GenerationManager& manager) {
+    io.outputstring("\n--- Network Configuration ---\n");
+    io.outputstring("Technology: ");
+    io.outputstring(manager.getTechName());
+    io.terminate();
+    io.outputstring("Protocol: ");
+    io.outputstring(manager.getProtocol());
+    io.terminate();
+    io.outputstring("Spectrum: ");
+    io.outputint(static_cast<int>(manager.getTotalSpectrumMHz()));
+    io.outputstring(" MHz");
+    io.terminate();
+    io.outputstring("Max Users (Spectrum): ");
+    io.outputint(manager.getMaxUsersBySpectrum());
+    io.terminate();
+    if (manager.hasMeasuredReuse()) {
+        char storage[128];
+        OutBuffer out(storage, sizeof(storage));
+        out.put("Spatial Reuse: ").putFixed(manager.getSpatialReuse(), 2)
+           .put(" layers (MU-MIMO grouping, profile ").putInt(manager.getMaxLayers()).put(")\n");
+        out.flush(1);
+    }
+    io.outputstring("Current Users: ");
+    io.outputint(manager.getUserCount());
+    io.terminate();
+    io.outputstring("Cores Needed for Full Capacity: ");
+    io.outputint(manager.getCoresNeededForFull());
+    io.terminate();
+    // 🔥 Running aggregates - O(1) regardless of slot or user count
+    io.outputstring("Slot Utilisation: ");
+    io.outputint(manager.getUtilisation());
+    io.outputstring("% (");
+    io.outputint(manager.getFullSlotCount());
+    io.outputstring(" of ");
+    io.outputint(manager.getSlotCount());
+    io.outputstring(" slots full)\n");
+    io.outputstring("Total Messages: ");
+    io.outputint(static_cast<int>(manager.getTotalMessages()));
+    io.terminate();
+    if (manager.getCapacityKind() != NetworkConfig::CAPACITY_FIXED) {
+        // 🔥 SINR capacity model: demand against carrier bandwidth decides admission
+        char storage[256];
+        OutBuffer out(storage, sizeof(storage));
+        out.put("Capacity Model: ")
+           .put(manager.getCapacityKind() == NetworkConfig::CAPACITY_CQI ? "CQI table" : "Shannon")
+           .put(", SINR ").putFixed(manager.getSinrMeanDb(), 1).put(" dB (sd ").putFixed(manager.getSinrSpreadDb(), 1)
+           .put(" dB), ").putInt(static_cast<long>(manager.getCarrierKhz())).put(" kHz per slot\n");
+        out.put("Carrier Demand: ").putInt(manager.getDemandUtilisation()).put("% of all slots\n");
+        out.flush(1);
+    }
+    if (manager.getMaxCarriers() > 1) {
+        io.outputstring("Carrier Aggregation: up to ");
+        io.outputint(manager.getMaxCarriers());
+        io.outputstring(" carriers per user, ");
+        io.outputint(manager.getAggregatedUserCount());
+        io.outputstring(" users aggregated\n");
+    }
+    io.outputstring("Users by Service: Voice ");
+    io.outputint(manager.getServiceUsers(1));
+    io.outputstring(", SMS ");
+    io.outputint(manager.getServiceUsers(2));
+    io.outputstring(", Data ");
+    io.outputint(manager.getServiceUsers(3));
+    io.outputstring(", Voice+Data ");
+    io.outputint(manager.getServiceUsers(4));
+    io.terminate();
+}
+
+void choosePlacementPolicy() {
+    io.outputstring("\n--- Placement Policy ---\n");
+    io.outputstring("1: First-fit (lowest frequency with space)\n");
+    io.outputstring("2: Least-loaded (lowest utilisation)\n");
+    io.outputstring("3: Load-balanced (lowest message weight)\n");
+    io.outputstring("Choice (1-3): ");
+    int p = InputValidator::validateInt(1, 3);
+    if (p == 1) placement_policy = GenerationManager::PLACE_FIRST_FIT;
+    else if (p == 2) placement_policy = GenerationManager::PLACE_LEAST_LOADED;
+    else placement_policy = GenerationManager::PLACE_LOAD_BALANCED;
+    io.outputstring("Re-place users whose frequency is full? (1=yes, 0=no): ");
+    spill_on_full = InputValidator::validateInt(0, 1) == 1;
+    io.outputstring("Placement policy updated.\n");
+}
+
+void runTopologyMode() {
+    io.outputstring("\n--- Multi-Cell Topology ---\n");
+    io.outputstring("Generation (2-7): ");
+    int gen = InputValidator::validateInt(2, 7);
+    io.outputstring("Grid rows (1-1000): ");
+    int rows = InputValidator::validateInt(1, 1000);
+    io.outputstring("Grid columns (1-1000): ");
+    int cols = InputValidator::validateInt(1, 1000);
+    io.outputstring("Users to place (1-10000000): ");
+    int users = InputValidator::validateInt(1, 10000000);
+    io.outputstring("Hotspot share of users in % (0-100): ");
+    int hotspot = InputValidator::validateInt(0, 100);
+    // Each worker owns at least one grid row of cells
+    int max_threads = rows < Topology::MAX_PARTITIONS ? rows : Topology::MAX_PARTITIONS;
+    io.outputstring("Worker threads (1-");
+    io.outputint(max_threads);
+    io.outputstring("): ");
+    int threads = InputValidator::validateInt(1, max_threads);
+    io.outputstring("Handover rounds (1-100): ");
+    int rounds = InputValidator::validateInt(1, 100);
+
+    Topology topology(gen, rows, cols, threads);
+    long placed = topology.populate(users, hotspot, 42);
+    Topology::Stats stats = topology.rebalance(rounds);
+
+    io.outputstring("\n--- Handover Results (");
+    io.outputstring(NetworkConfig::profile(gen).name);
+    io.outputstring(") ---\n");
+    io.outputstring("Cells: ");
+    io.outputint(topology.getCellCount());
+    io.outputstring(" across ");
+    io.outputint(topology.getPartitionCount());
+    io.outputstring(" partitions\n");
+    io.outputstring("Users placed: ");
+    io.outputint(static_cast<int>(placed));
+    io.terminate();
+    io.outputstring("Congested cells: ");
+    io.outputint(stats.congested_before);
+    io.outputstring(" -> ");
+    io.outputint(stats.congested_after);
+    io.terminate();
+    io.outputstring("Handovers: ");
+    io.outputint(static_cast<int>(stats.intra + stats.cross));
+    io.outputstring(" (");
+    io.outputint(static_cast<int>(stats.cross));
+    io.outputstring(" cross-partition, ");
+    io.outputint(static_cast<int>(stats.bounced));
+    io.outputstring(" refused, ");
+    io.outputint(static_cast<int>(stats.deferred));
+    io.outputstring(" deferred)\n");
+    io.outputstring("Rebalance time: ");
+    io.outputint(static_cast<int>(stats.elapsed_us));
+    io.outputstring(" us\n");
+}
+
+// 🔥 Users with positions served by their nearest tower site; reports
+// hotspot sites and the cost of bulk assignment and incremental moves
+void runCoverageMode() {
+    io.outputstring("\n--- Coverage Map ---\n");
+    io.outputstring("Generation (2-7): ");
+    int gen = InputValidator::validateInt(2, 7);
+    io.outputstring("Tower sites (1-1000000): ");
+    int sites = InputValidator::validateInt(1, 1000000);
+    io.outputstring("Inter-site distance in m (50-50000): ");
+    int spacing = InputValidator::validateInt(50, 50000);
+    io.outputstring("Users to place (1-10000000): ");
+    int users = InputValidator::validateInt(1, 10000000);
+    io.outputstring("Hotspot share of users in % (0-100): ");
+    int hotspot = InputValidator::validateInt(0, 100);
+    io.outputstring("Worker threads (1-64): ");
+    int threads = InputValidator::validateInt(1, Coverage::MAX_THREADS);
+    io.outputstring("Movement rounds (0-100): ");
+    int rounds = InputValidator::validateInt(0, 100);
+    int step = 0;
+    if (rounds > 0) {
+        io.outputstring("Step per round in m (1-10000): ");
+        step = InputValidator::validateInt(1, 10000);
+    }
+
+    Coverage coverage(gen, sites, static_cast<float>(spacing));
+    coverage.populate(users, hotspot, threads);
+    Coverage::Stats s = coverage.assignAll(threads);
+
+    char storage[1024];
+    OutBuffer out(storage, sizeof(storage));
+    out.put("\n--- Coverage (").put(NetworkConfig::profile(gen).name).put(") ---\n");
+    out.put("Sites: ").putInt(coverage.getSiteCount()).put(" | Capacity per site: ")
+       .putInt(coverage.getSiteCapacity()).put(" users\n");
+    out.put("Assigned ").putInt(s.users).put(" users in ").putInt(s.elapsed_us / 1000).put(" ms (")
+       .putInt(s.elapsed_us > 0 ? s.users * 1000000 / s.elapsed_us : s.users).put(" users/sec)\n");
+    out.put("Overloaded sites: ").putInt(s.overloaded).put(" | Busiest: site ").putInt(s.busiest).put(" with ")
+       .putInt(coverage.getSiteLoad(s.busiest)).put(" users\n");
+    out.put("Beyond one site spacing: ").putInt(s.out_of_range).put(" users\n");
+    out.flush(1);
+    for (int r = 0; r < rounds; ++r) {
+        Coverage::Stats m = coverage.moveAll(static_cast<float>(step), threads, r + 1);
+        out.put("Move ").putInt(r + 1).put(": ").putInt(m.handovers).put(" handovers, ")
+           .putInt(m.overloaded).put(" overloaded sites, ").putInt(m.elapsed_us / 1000).put(" ms\n");
+        out.flush(1);
+    }
+}
+
+GenerationManager& fileManager(int gen) {
+    if (file_managers[gen] == nullptr) {
+        file_cores[gen] = new CellularCore<long>(100); // 🔥 100 message limit
+        file_managers[gen] = new GenerationManager(gen, file_cores[gen]);
+    } else {
+        file_managers[gen]->reset();
+    }
+    return *file_managers[gen];
+}
+
+GenerationManager* ensureManager(int gen) {
+    if (gen_managers[gen] == nullptr) {
+        gen_cores[gen] = new CellularCore<long>(100);          // NEW: dedicated core
+        gen_managers[gen] = new GenerationManager(gen, gen_cores[gen]);
+        gen_managers[gen]->setPlacementPolicy(placement_policy, spill_on_full);
+        if (preemption_enabled) gen_managers[gen]->setPreemption(true);
+    }
+    return gen_managers[gen];
+}
+
+void showFallbackMenu() {
+    io.outputstring("\n--- Fallback Admission ---\n");
+    io.outputstring("Status: ");
+    io.outputstring(fallback_chain.isEnabled() ? "ON" : "OFF");
+    io.terminate();
+    io.outputstring("Gen   Offered  Carried  Overflow\n");
+    for (int g = NetworkConfig::MAX_GEN; g >= NetworkConfig::MIN_GEN; --g) {
+        const FallbackChain::Counters& c = fallback_chain.get(g);
+        if (c.offered == 0) continue;
+        io.outputstring(NetworkConfig::profile(g).name);
+        io.outputstring("  ");
+        io.outputint(static_cast<int>(c.offered));
+        io.outputstring("  ");
+        io.outputint(static_cast<int>(c.carried));
+        io.outputstring("  ");
+        io.outputint(static_cast<int>(c.overflow));
+        io.terminate();
+    }
+    io.outputstring("Lost: ");
+    io.outputint(static_cast<int>(fallback_chain.getLost()));
+    io.terminate();
+    io.outputstring("1: Enable  2: Disable  3: Reset counters  0: Back\nChoice (0-3): ");
+    int c = InputValidator::validateInt(0, 3);
+    if (c == 1) fallback_chain.setEnabled(true);
+    else if (c == 2) fallback_chain.setEnabled(false);
+    else if (c == 3) fallback_chain.reset();
+}
+
+// 🔥 Per-class admission outcomes for the current generation; the
+// preemption switch applies to all of them
+void showQosMenu(const GenerationManager& manager) {
+    static const char* names[4] = {"Voice", "SMS", "Data", "Voice+Data"};
+    io.outputstring("\n--- QoS Admission (");
+    io.outputstring(manager.getTechName());
+    io.outputstring(") ---\nPreemption: ");
+    io.outputstring(preemption_enabled ? "ON" : "OFF");
+    io.terminate();
+    io.outputstring("Class       Prio  Offered  Admitted  Blocked  Preempted  Evicted\n");
+    for (int service = 1; service <= 4; ++service) {
+        const GenerationManager::QosCounters& q = manager.getQos(service);
+        io.outputstring(names[service - 1]);
+        io.outputstring("  ");
+        io.outputint(manager.getServicePriority(service));
+        io.outputstring("  ");
+        io.outputint(static_cast<int>(q.offered));
+        io.outputstring("  ");
+        io.outputint(static_cast<int>(q.admitted));
+        io.outputstring("  ");
+        io.outputint(static_cast<int>(q.blocked));
+        io.outputstring("  ");
+        io.outputint(static_cast<int>(q.preemptions));
+        io.outputstring("  ");
+        io.outputint(static_cast<int>(q.evicted));
+        io.terminate();
+    }
+    io.outputstring("1: Enable preemption  2: Disable  0: Back\nChoice (0-2): ");
+    int c = InputValidator::validateInt(0, 2);
+    if (c == 1) preemption_enabled = true;
+    else if (c == 2) preemption_enabled = false;
+}
+
+void showPerfStats() {
+#ifdef CELLSIM_PERF
+    static char storage[8192];
+    OutBuffer out(storage, sizeof(storage));
+    Perf::dump(out);
+    out.put("1: Reset counters  0: Back\nChoice (0-1): ");
+    out.flush(1);
+    if (InputValidator::validateInt(0, 1) == 1) {
+        Perf::reset();
+        io.outputstring("Counters reset.\n");
+    }
+#else
+    io.outputstring("\nPerformance counters are compiled out of this build (build with -DCELLSIM_PERF, e.g. make debug).\n");
+#endif
+}
+
+// Reads a whole file into a new[] buffer (NUL-terminated); nullptr if it cannot be read
+static char* readWholeFile(const char* path, long& bytes) {
+    return FileIO::load(path, bytes, [](const char*, long) {});
+}
+
+// 🔥 Loads every generation's records from `path` through the quiet admission
+// path and prints one summary line per generation plus the perf counters
+int runHeadless(const char* path, const char* export_path) {
+    long bytes = 0;
+    char* buf = readWholeFile(path, bytes);
+    if (!buf) {
+        io.errorstring("❌ ERROR: cannot read ");
+        io.errorstring(path);
+        io.errorstring("\n");
+        return 1;
+    }
+    static char storage[8192];
+    OutBuffer out(storage, sizeof(storage));
+    for (int g = NetworkConfig::MIN_GEN; g <= NetworkConfig::MAX_GEN; ++g) {
+        GenerationManager* manager = ensureManager(g);
+        long admitted = 0;
+        long records = 0;
+        {
+            PERF_SCOPE(T_PARSE);
+            records = InputParser::forEachRecord(buf, bytes, g, [&](int service, int freq, int carriers) {
+                int placed = 0;
+                if (manager->tryAddUserPlaced(service, freq, placed, carriers) == GenerationManager::ADMIT_OK)
+                    ++admitted;
+            });
+        }
+        PERF_COUNT_N(PARSED_RECORDS, records);
+        if (records == 0) continue;
+        out.put(manager->getTechName()).put(": ").putInt(records).put(" records, ")
+           .putInt(admitted).put(" admitted, ").putInt(records - admitted).put(" rejected\n");
+    }
+    delete[] buf;
+#ifdef CELLSIM_PERF
+    Perf::dump(out);
+#endif
+    out.flush(1);
+    if (export_path && !exportMetrics(export_path)) return 1;
+    return 0;
+}
+
+// 🔥 Replays a trace recorded with --record; nothing is printed until the end
+int runReplay(const char* path) {
+    long bytes = 0;
+    char* buf = readWholeFile(path, bytes);
+    if (!buf) {
+        io.errorstring("❌ ERROR: cannot read ");
+        io.errorstring(path);
+        io.errorstring("\n");
+        return 1;
+    }
+    TraceReplay::Result r = TraceReplay::run(buf, bytes);
+    delete[] buf;
+    if (!r.valid) {
+        io.errorstring("❌ ERROR: ");
+        io.errorstring(path);
+        io.errorstring(" is not a cellsim trace\n");
+        return 1;
+    }
+    static char storage[8192];
+    OutBuffer out(storage, sizeof(storage));
+    out.put("Replayed ").putInt(r.ops).put(" operations (").putInt(r.adds).put(" add, ")
+       .putInt(r.removes).put(" remove, ").putInt(r.queries).put(" query) in ")
+       .putInt(r.elapsed_ns / 1000).put(" us, ")
+       .putFixed(r.ops > 0 ? static_cast<double>(r.elapsed_ns) / r.ops : 0.0, 1).put(" ns/op\n");
+    out.put(r.mismatches == 0 ? "✅ " : "❌ ").putInt(r.mismatches).put(" verdicts differ from the recording");
+    if (r.skipped > 0) out.put(", ").putInt(r.skipped).put(" records skipped");
+    out.put('\n');
+#ifdef CELLSIM_PERF
+    Perf::dump(out);
+#endif
+    out.flush(1);
+    return r.mismatches == 0 ? 0 : 1;
+}
+
+// 🔥 WATCH MODE: live table of every active generation, driven by random churn
+// Draws the dashboard over the interactive engines. Churn mutates them, so
+// runWatchMode() only passes churn > 0 inside a WhatIf fork.
+static int watchEngines(int hz, int seconds, int churn) {
+    GenerationManager* engines[8];
+    const GenerationManager* active[8];
+    int n = 0;
+    for (int g = NetworkConfig::MIN_GEN; g <= NetworkConfig::MAX_GEN; ++g) {
+        if (!gen_managers[g]) continue;
+        engines[n] = gen_managers[g];
+        active[n++] = gen_managers[g];
+    }
+
+    Dashboard dashboard;
+    unsigned long rng = static_cast<unsigned long>(Clock::nowNs()) | 1;
+    long period = 1000000000L / hz;
+    long frames = static_cast<long>(seconds) * hz;
+    long ops = 0, carry = 0;
+    long start = Clock::nowNs();
+    char status[80];
+    for (long f = 0; f <= frames; ++f) {
+        // Spread the churn evenly over frames; adds slightly outnumber removes
+        carry += churn;
+        for (; carry >= hz; carry -= hz, ++ops) {
+            rng ^= rng << 13; rng ^= rng >> 7; rng ^= rng << 17;
+            GenerationManager* m = engines[rng % n];
+            int count = m->getUserCount();
+            if (count == 0 || (rng >> 8) % 100 < 55) {
+                int freq = 0;
+                m->tryAddUserAuto(1 + static_cast<int>((rng >> 16) % 4), freq);
+            } else {
+                m->removeUser(1 + static_cast<int>((rng >> 20) % count));
+            }
+        }
+        OutBuffer line(status, sizeof(status) - 1);
+        line.put("frame ").putInt(f).put('/').putInt(frames).put("  ops ").putInt(ops)
+            .put("  ").putInt(hz).put(" Hz");
+        if (churn > 0) line.put("  what-if");
+        status[line.size()] = '\0';
+        dashboard.draw(active, n, status);
+        Dashboard::sleepUntil(start + (f + 1) * period);
+    }
+    dashboard.finish();
+    return 0;
+}
+
+// 🔥 Observes the live engines; synthetic churn runs on a copy-on-write fork
+// so the interactive session is never changed by watching it
+void runWatchMode() {
+    int n = 0;
+    for (int g = NetworkConfig::MIN_GEN; g <= NetworkConfig::MAX_GEN; ++g)
+        if (gen_managers[g]) ++n;
+    if (n == 0) {
+        io.outputstring("No active generations - open one in Interactive Mode first.\n");
+        return;
+    }
+    io.outputstring("Refresh rate (1-60 Hz): ");
+    int hz = InputValidator::validateInt(1, 60);
+    io.outputstring("Duration (1-3600 s): ");
+    int seconds = InputValidator::validateInt(1, 3600);
+    io.outputstring("Churn (0-1000000 add/remove ops per second, applied to a what-if fork): ");
+    int churn = InputValidator::validateInt(0, 1000000);
+
+    if (churn == 0) {
+        watchEngines(hz, seconds, 0);
+        return;
+    }
+    WhatIf::Result r = WhatIf::run([hz, seconds, churn]() { return watchEngines(hz, seconds, churn); });
+    if (!r.forked) {
+        io.errorstring("❌ ERROR: cannot fork the simulator for synthetic churn\n");
+        return;
+    }
+    io.outputstring("🗑️ Churn ran on a what-if fork; live state unchanged.\n");
+}
+
+// Replays a trace at its recorded pace (times `speed`) on the live dashboard
+int runWatchReplay(const char* path, int hz, int speed) {
+    if (hz < 1) hz = 1;
+    if (hz > 60) hz = 60;
+    if (speed < 1) speed = 1;
+    long bytes = 0;
+    char* buf = readWholeFile(path, bytes);
+    TraceReplay* replay = buf ? new TraceReplay(buf, bytes) : nullptr;
+    if (!replay || !replay->isValid()) {
+        io.errorstring("❌ ERROR: ");
+        io.errorstring(path);
+        io.errorstring(" is not a readable cellsim trace\n");
+        delete replay;
+        delete[] buf;
+        return 1;
+    }
+    Dashboard dashboard;
+    const GenerationManager* engines[Dashboard::MAX_ENGINES];
+    long period = 1000000000L / hz;
+    long start = Clock::nowNs();
+    char status[80];
+    for (long f = 0;; ++f) {
+        long trace_us = (f * period / 1000) * speed;
+        while (!replay->done() && replay->nextTimeUs() <= trace_us) replay->step();
+        int n = replay->getEngines(engines, Dashboard::MAX_ENGINES);
+        OutBuffer line(status, sizeof(status) - 1);
+        line.put("replay ").putInt(replay->getPosition()).put('/').putInt(replay->getRecordCount())
+            .put(" records  t=").putInt(trace_us / 1000000).put("s  x").putInt(speed);
+        status[line.size()] = '\0';
+        dashboard.draw(engines, n, status);
+        if (replay->done()) break;
+        Dashboard::sleepUntil(start + (f + 1) * period);
+    }
+    dashboard.finish();
+    long mismatches = replay->result().mismatches;
+    delete replay;
+    delete[] buf;
+    return mismatches == 0 ? 0 : 1;
+}
+
+// 🔥 Writes every active generation to `path` (CSV for *.csv, JSON otherwise)
+// from one reusable buffer with a single write
+bool exportMetrics(const char* path) {
+    const GenerationManager* active[8];
+    int n = 0;
+    for (int g = NetworkConfig::MIN_GEN; g <= NetworkConfig::MAX_GEN; ++g)
+        if (gen_managers[g]) active[n++] = gen_managers[g];
+
+    int len = 0;
+    while (path[len]) ++len;
+    bool csv = len >= 4 && argEquals(path + len - 4, ".csv");
+
+    static char* storage = nullptr;
+    static long storage_size = 0;
+    long need = MetricsExport::maxBytes(active, n);
+    if (need > storage_size) {
+        delete[] storage;
+        storage = new char[need];
+        storage_size = need;
+    }
+    OutBuffer out(storage, storage_size);
+    MetricsExport::write(out, active, n, csv ? MetricsExport::FORMAT_CSV : MetricsExport::FORMAT_JSON);
+
+    // Scrapers never see a half-written export: "<path>.tmp" + fsync + rename
+    if (!FileIO::saveAtomic(path, out.data(), out.size())) {
+        io.errorstring("❌ ERROR: cannot write ");
+        io.errorstring(path);
+        io.errorstring("\n");
+        return false;
+    }
+    return true;
+}
+
+void showExportMenu() {
+    io.outputstring("\n--- Export Metrics ---\n");
+    io.outputstring("1: JSON (metrics.json)\n");
+    io.outputstring("2: CSV (metrics.csv)\n");
+    io.outputstring("Choice (1-2): ");
+    const char* path = InputValidator::validateInt(1, 2) == 1 ? "metrics.json" : "metrics.csv";
+    if (exportMetrics(path)) {
+        io.outputstring("✅ Metrics written to ");
+        io.outputstring(path);
+        io.terminate();
+    }
+}
+
+// 🔥 Runs the slot's users through the per-TTI scheduler and reports the
+// throughput and fairness it produced
+void runSchedulerMenu(const GenerationManager& manager) {
+    int rbs = TtiScheduler::resourceBlocksFor(manager.getGeneration());
+    if (rbs == 0) {
+        io.errorstring("❌ ERROR: TTI scheduling applies to the OFDM generations (4G, 4G+, 5G).\n");
+        return;
+    }
+    io.outputstring("Frequency to schedule (MHz): ");
+    int f = InputValidator::validateInt(1, 100000);
+    int slot_idx = manager.findSlot(f);
+    if (slot_idx < 0) {
+        io.errorstring("❌ ERROR: Frequency ");
+        io.errorint(f);
+        io.errorstring(" MHz is not valid for ");
+        io.errorstring(manager.getTechName());
+        io.errorstring(" generation.\n");
+        return;
+    }
+    io.outputstring("Policy (1: Round-robin, 2: Proportional fair): ");
+    TtiScheduler::Policy policy = InputValidator::validateInt(1, 2) == 1
+        ? TtiScheduler::POLICY_ROUND_ROBIN : TtiScheduler::POLICY_PROPORTIONAL_FAIR;
+    io.outputstring("TTIs to simulate (1 ms each, 1-100000): ");
+    long ttis = InputValidator::validateInt(1, 100000);
+
+    TtiScheduler sched(rbs, manager.getUserCount() > 0 ? manager.getUserCount() : 1);
+    if (sched.loadSlot(manager, slot_idx) == 0) {
+        io.outputstring("No users on this frequency.\n");
+        return;
+    }
+    long start = Clock::nowNs();
+    sched.run(policy, ttis);
+    long elapsed = Clock::nowNs() - start;
+
+    char storage[512];
+    OutBuffer out(storage, sizeof(storage));
+    out.put("\n--- TTI Scheduler: ").putInt(f).put(" MHz, ")
+       .put(policy == TtiScheduler::POLICY_ROUND_ROBIN ? "round-robin" : "proportional fair").put(" ---\n");
+    out.put("Users: ").putInt(sched.getUserCount()).put(" | RBs per TTI: ").putInt(rbs)
+       .put(" | Simulated: ").putInt(ttis).put(" ms\n");
+    out.put("Cell throughput: ").putFixed(sched.getThroughputMbps(), 2).put(" Mbit/s");
+    out.put(" | Per user: ").putFixed(sched.getThroughputMbps() / sched.getUserCount(), 3).put(" Mbit/s\n");
+    out.put("Fairness (Jain): ").putFixed(sched.getFairness(), 3);
+    out.put(" | Speed: x").putInt(elapsed > 0 ? ttis * TtiScheduler::TTI_US * 1000L / elapsed : 0).put(" real time\n");
+    out.flush(1);
+}
+
+// 🔥 Serves the shared generation managers over a Unix socket until SHUTDOWN
+int runServer(const char* path) {
+    ControlServer* server = new ControlServer(path, ensureManager); // ~32MB of connection buffers
+    if (!server->open()) {
+        io.errorstring("❌ ERROR: cannot listen on ");
+        io.errorstring(path);
+        io.errorstring("\n");
+        delete server;
+        return 1;
+    }
+    io.outputstring("Listening on ");
+    io.outputstring(path);
+    io.terminate();
+    ControlServer::Stats stats = server->run();
+    delete server;
+    static char storage[8192];
+    OutBuffer out(storage, sizeof(storage));
+    out.put("Server stopped: ").putInt(stats.connections).put(" connections, ")
+       .putInt(stats.requests).put(" requests, ").putInt(stats.errors).put(" errors, ")
+       .putInt(stats.sends).put(" sends\n");
+#ifdef CELLSIM_PERF
+    Perf::dump(out);
+#endif
+    out.flush(1);
+    return 0;
+}
+
+// 🔥 MU-MIMO grouping: the slot's own users, then a full synthetic slot whose
+// reuse factor replaces antenna_factor in the manager's capacity figures
+void runMimoMenu(GenerationManager& manager) {
+    int layers = manager.getMaxLayers();
+    if (layers <= 1) {
+        io.errorstring("❌ ERROR: MU-MIMO grouping applies to the MIMO generations (4G, 4G+, 5G).\n");
+        return;
+    }
+    io.outputstring("Frequency to group (MHz): ");
+    int f = InputValidator::validateInt(1, 100000);
+    int slot_idx = manager.findSlot(f);
+    if (slot_idx < 0) {
+        io.errorstring("❌ ERROR: Frequency ");
+        io.errorint(f);
+        io.errorstring(" MHz is not valid for ");
+        io.errorstring(manager.getTechName());
+        io.errorstring(" generation.\n");
+        return;
+    }
+
+    char storage[1024];
+    OutBuffer out(storage, sizeof(storage));
+    MuMimoGrouper grouper(layers, manager.getUserCount() > 0 ? manager.getUserCount() : 1);
+    out.put("\n--- MU-MIMO Grouping: ").putInt(f).put(" MHz, ").putInt(grouper.getAntennas())
+       .put(" antennas, up to ").putInt(layers).put(" layers ---\n");
+    if (grouper.loadSlot(manager, slot_idx) == 0) {
+        out.put("No users on this frequency.\n");
+    } else {
+        grouper.group();
+        out.put("Users: ").putInt(grouper.getUserCount()).put(" | Groups: ").putInt(grouper.getGroupCount())
+           .put(" | Mean group size: ").putFixed(grouper.getMeanGroupSize(), 2)
+           .put(" | Effective layers: ").putFixed(grouper.getSpatialReuse(), 2).put('\n');
+    }
+
+    // Capacity comes from what the array achieves on a full slot
+    int full = manager.getSlotMaxUsers(slot_idx);
+    MuMimoGrouper sample(layers, full);
+    unsigned long salt = static_cast<unsigned long>(f) << 32;
+    for (int i = 0; i < full; ++i) sample.addUser(salt + static_cast<unsigned long>(i + 1));
+    long start = Clock::nowNs();
+    sample.group();
+    long elapsed = Clock::nowNs() - start;
+    manager.setSpatialReuse(sample.getSpatialReuse());
+    out.put("Full slot (").putInt(full).put(" users): ").putInt(sample.getGroupCount()).put(" groups, spatial reuse ")
+       .putFixed(sample.getSpatialReuse(), 2).put(" (profile constant ").putInt(layers).put(") in ")
+       .putInt(elapsed / 1000).put(" us\n");
+    out.put("✅ Max Users (Spectrum) now ").putInt(manager.getMaxUsersBySpectrum()).put('\n');
+    out.flush(1);
+}
+
+// 🔥 Runs the generation's message load on worker threads, one per core, and
+// checks the getCoresNeededForFull() estimate against the measured busy time
+void runWorkersMenu(const GenerationManager& manager) {
+    io.outputstring("Load (1: Current users, 2: Full spectrum): ");
+    int load = InputValidator::validateInt(1, 2);
+    int estimate = manager.getCoresNeededForFull();
+    io.outputstring("Worker cores (1-64): ");
+    int workers = InputValidator::validateInt(1, CoreWorkers::MAX_WORKERS);
+    io.outputstring("CPU per message (ns, 0-100000): ");
+    int message_ns = InputValidator::validateInt(0, 100000);
+    io.outputstring("Rounds (1-1000): ");
+    int rounds = InputValidator::validateInt(1, 1000);
+
+    CoreWorkers pool(workers, message_ns);
+    long jobs = load == 1 ? pool.loadManager(manager) : pool.loadFull(manager);
+    if (jobs == 0) {
+        io.outputstring("No users to process.\n");
+        return;
+    }
+    CoreWorkers::Stats s = pool.run(rounds);
+
+    char storage[1024];
+    OutBuffer out(storage, sizeof(storage));
+    out.put("\n--- Core Workers: ").putInt(s.workers).put(" cores, ").putInt(jobs).put(" jobs/round, ")
+       .putInt(s.rounds).put(" rounds ---\n");
+    out.put("Messages: ").putInt(s.messages).put(" in ").putInt(s.elapsed_ns / 1000).put(" us (")
+       .putInt(static_cast<long>(s.msgs_per_sec)).put(" msgs/sec)\n");
+    out.put("Stolen jobs: ").putInt(s.stolen).put(" | Queue depth: max ").putInt(s.max_depth)
+       .put(", mean ").putFixed(s.mean_depth, 1).put('\n');
+    out.put("Latency ns: p50 ").putInt(s.p50_ns).put(" | p90 ").putInt(s.p90_ns)
+       .put(" | p99 ").putInt(s.p99_ns).put(" | max ").putInt(s.max_ns).put('\n');
+    // A core's budget is getCoreCapacity() messages per round
+    long period_ns = manager.getCoreCapacity() * message_ns;
+    if (period_ns > 0) {
+        long per_round = s.busy_ns / s.rounds;
+        out.put("Cores needed: estimate ").putInt(estimate).put(load == 1 ? " (full spectrum)" : "")
+           .put(" | measured ").putInt((per_round + period_ns - 1) / period_ns)
+           .put(" (busy ").putInt(per_round / 1000).put(" us per round, ")
+           .putInt(period_ns / 1000).put(" us per core)\n");
+    }
+    out.flush(1);
+}
+
+// 🔥 Post-outage re-registration storm against the generation's core, under
+// one overload-control policy or all four side by side
+void runStormMenu(const GenerationManager& manager) {
+    static const char* names[4] = {"None", "Token bucket", "Backoff", "Bounded queue"};
+    io.outputstring("Devices (1-10000000): ");
+    long devices = InputValidator::validateInt(1, 10000000);
+    io.outputstring("Core throughput (messages/sec, 1000-100000000): ");
+    long rate = InputValidator::validateInt(1000, 100000000);
+    io.outputstring("Policy (1: None, 2: Token bucket, 3: Backoff, 4: Bounded queue, 0: All): ");
+    int choice = InputValidator::validateInt(0, 4);
+
+    SignallingStorm::Settings settings = SignallingStorm::defaults(devices);
+    settings.core_msgs_per_sec = rate;
+    SignallingStorm storm(manager.getGeneration(), settings);
+    io.outputstring("\n--- Signalling Storm (");
+    io.outputstring(manager.getTechName());
+    io.outputstring("): core completes ");
+    io.outputint(static_cast<int>(storm.getRegistrationsPerSec()));
+    io.outputstring(" registrations/sec ---\n");
+    for (int p = 0; p < 4; ++p) {
+        if (choice != 0 && choice != p + 1) continue;
+        OverloadControl::Policy policy = static_cast<OverloadControl::Policy>(p);
+        SignallingStorm::Result r = storm.run(OverloadControl::defaults(policy, storm.getRegistrationsPerSec()));
+        char storage[1024];
+        OutBuffer out(storage, sizeof(storage));
+        out.put(names[p]).put(": ").putInt(r.registered).put('/').putInt(devices).put(" registered in ")
+           .putInt(r.finish_ns / 1000000).put(" ms (").putInt(static_cast<long>(r.registrations_per_sec))
+           .put(" registrations/sec");
+        if (r.t99_ns >= 0) out.put(", 99% by ").putInt(r.t99_ns / 1000000).put(" ms");
+        out.put(")\n  Attempts ").putInt(r.attempts).put(" | Rejected ").putInt(r.rejected)
+           .put(" | Timed out ").putInt(r.timed_out).put(" | Abandoned ").putInt(r.abandoned)
+           .put(" | Wasted core time ").putInt(r.busy_ns > 0 ? r.wasted_ns * 100 / r.busy_ns : 0).put("%\n");
+        out.put("  Queue delay ms: p50 ").putInt(r.delay_p50_ns / 1000000).put(" | p99 ")
+           .putInt(r.delay_p99_ns / 1000000).put(" | max ").putInt(r.delay_max_ns / 1000000)
+           .put(" | Max queue ").putInt(r.max_queue).put('\n');
+        out.put("  Simulated ").putInt(static_cast<long>(r.attempts_per_sec)).put(" attempts/sec\n");
+        out.flush(1);
+    }
+}
+
+// 🔥 WHAT-IF FORK: the snapshot each generation is compared against
+struct EngineSummary {
+    bool exists;
+    int users;
+    int utilisation;
+    int full_slots;
+    long messages;
+    long core_load;
+};
+
+static EngineSummary summarise(int gen) {
+    EngineSummary e = {false, 0, 0, 0, 0, 0};
+    const GenerationManager* m = gen_managers[gen];
+    if (!m) return e;
+    e.exists = true;
+    e.users = m->getUserCount();
+    e.utilisation = m->getUtilisation();
+    e.full_slots = m->getFullSlotCount();
+    e.messages = m->getTotalMessages();
+    e.core_load = m->getCoreLoad();
+    return e;
+}
+
+static void putChange(OutBuffer& out, long before, long after, const char* unit) {
+    out.putInt(before).put(unit);
+    if (after == before) return;
+    out.put(" -> ").putInt(after).put(unit).put(" (").put(after > before ? "+" : "").putInt(after - before).put(')');
+}
+
+static void printWhatIfComparison(const EngineSummary live[8]) {
+    io.outputstring("\n--- What-if vs Live ---\n");
+    bool any = false;
+    for (int g = 2; g <= 7; ++g) {
+        EngineSummary fork = summarise(g);
+        if (!live[g].exists && !fork.exists) continue;
+        any = true;
+        char storage[512];
+        OutBuffer out(storage, sizeof(storage));
+        out.put(gen_managers[g]->getTechName()).put(": users ");
+        putChange(out, live[g].users, fork.users, "");
+        out.put(" | utilisation ");
+        putChange(out, live[g].utilisation, fork.utilisation, "%");
+        out.put(" | full slots ");
+        putChange(out, live[g].full_slots, fork.full_slots, "");
+        out.put("\n    messages ");
+        putChange(out, live[g].messages, fork.messages, "");
+        out.put(" | core load ");
+        putChange(out, live[g].core_load, fork.core_load, "");
+        out.put('\n');
+        out.flush(1);
+    }
+    if (!any) io.outputstring("  (No generations in use)\n");
+}
+
+// Runs in the forked child: every change here is discarded when it returns
+static int runWhatIfMenu(int gen) {
+    EngineSummary live[8];
+    for (int g = 2; g <= 7; ++g) live[g] = summarise(g);
+    while (1) {
+        try {
+            io.outputstring("\n[What-if Fork - changes are discarded on exit]\n");
+            io.outputstring("1. Add Users (bulk, auto placement)\n");
+            io.outputstring("2. Remove Users (most recent first)\n");
+            io.outputstring("3. Compare with Live State\n");
+            io.outputstring("4. View Spectrum Status\n");
+            io.outputstring("5. Discard & Return\n");
+            io.outputstring("Choice: ");
+            int c = InputValidator::validateInt(1, 5);
+            if (c == 5) return 0;
+            if (c == 3) {
+                printWhatIfComparison(live);
+                continue;
+            }
+            io.outputstring("Technology (2-7, 0 = current): ");
+            int g = InputValidator::validateInt(0, 7);
+            if (g == 0) g = gen;
+            if (g < 2) {
+                io.outputstring("Invalid choice.\n");
+                continue;
+            }
+            GenerationManager* m = ensureManager(g);
+            if (c == 1) {
+                io.outputstring("Service (1: Voice, 2: SMS, 3: Data, 4: Voice+Data): ");
+                int service = InputValidator::validateInt(1, 4);
+                io.outputstring("Users to add (1-10000): ");
+                int count = InputValidator::validateInt(1, 10000);
+                int added = 0, slot_full = 0, core_full = 0, other = 0;
+                long start = Clock::nowNs();
+                for (int k = 0; k < count; ++k) {
+                    int freq = 0;
+                    GenerationManager::AdmitResult r = m->tryAddUserAuto(service, freq);
+                    if (r == GenerationManager::ADMIT_OK) ++added;
+                    else if (r == GenerationManager::ADMIT_SLOT_FULL) ++slot_full;
+                    else if (r == GenerationManager::ADMIT_CORE_FULL) ++core_full;
+                    else ++other;
+                }
+                long elapsed = Clock::nowNs() - start;
+                char storage[256];
+                OutBuffer out(storage, sizeof(storage));
+                out.put(added == count ? "✅ " : "⚠️ ").putInt(added).put('/').putInt(count).put(" users added to ")
+                   .put(m->getTechName()).put(" in ").putInt(elapsed / 1000).put(" us");
+                if (added < count)
+                    out.put(" (slot full ").putInt(slot_full).put(", core full ").putInt(core_full)
+                       .put(", user limit ").putInt(other).put(')');
+                out.put('\n');
+                out.flush(1);
+            } else if (c == 2) {
+                io.outputstring("Users to remove (1-10000): ");
+                int count = InputValidator::validateInt(1, 10000);
+                int removed = 0;
+                while (removed < count && m->getUserCount() > 0) {
+                    m->removeUser(m->getUserCount());
+                    ++removed;
+                }
+                io.outputint(removed);
+                io.outputstring(" users removed from ");
+                io.outputstring(m->getTechName());
+                io.terminate();
+            } else {
+                printSpectrumStatus(*m);
+            }
+        }
+        catch (const CellularException& e) {
+            io.errorstring("❌ ERROR: ");
+            io.errorstring(e.what());
+            io.terminate();
+        }
+    }
+}
+
+void runWhatIf(int gen) {
+    WhatIf::Result r = WhatIf::run([gen]() { return runWhatIfMenu(gen); });
+    if (!r.forked) {
+        io.errorstring("❌ ERROR: cannot fork the simulator for a what-if run\n");
+        return;
+    }
+    char storage[256];
+    OutBuffer out(storage, sizeof(storage));
+    out.put("🗑️ What-if fork discarded (fork took ").putInt(r.fork_ns / 1000)
+       .put(" us); live state unchanged.\n");
+    out.flush(1);
+}